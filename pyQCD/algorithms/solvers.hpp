@@ -0,0 +1,184 @@
+#ifndef SOLVERS_HPP
+#define SOLVERS_HPP
+
+/* This file provides Krylov solvers operating directly on the Lattice and
+ * MatrixArray types from pyQCD/core, so the iteration runs in the same
+ * process and memory layout as the gauge field. Both solvers are templated
+ * on the operator type, which needs only an apply(out, in) member (e.g.
+ * WilsonDiracOperator or EvenOddPreconditionedWilson from
+ * fermions/wilson_dirac.hpp). conjugate_gradient requires a hermitian
+ * positive-definite operator; bicgstab handles general operators.
+ *
+ * Each solve returns per-iteration residuals and wall-clock timing so
+ * convergence can be monitored without instrumenting the call site.
+ */
+
+#include <chrono>
+#include <complex>
+#include <vector>
+
+#include <core/lattice.hpp>
+#include <core/matrix_array.hpp>
+
+
+namespace pyQCD
+{
+  template <typename Real>
+  struct SolverResults
+  {
+    unsigned int iterations;
+    Real final_residual;           // |b - A x| / |b|
+    std::vector<Real> residuals;   // relative residual after each iteration
+    double seconds;                // wall-clock time of the iteration loop
+  };
+
+
+  // Conjugate inner product summed over sites and spins:
+  // sum_x sum_alpha lhs(x)[alpha]^dag rhs(x)[alpha]
+  template <int N, typename T, template <typename> class Alloc>
+  std::complex<T> dot(const Lattice<MatrixArray<N, 1, T>, Alloc>& lhs,
+                      const Lattice<MatrixArray<N, 1, T>, Alloc>& rhs)
+  {
+    std::complex<T> ret(0.0, 0.0);
+    for (unsigned long i = 0; i < lhs.size(); ++i) {
+      for (unsigned long alpha = 0; alpha < lhs[i].size(); ++alpha) {
+        ret += lhs[i][alpha].dot(rhs[i][alpha]);
+      }
+    }
+    return ret;
+  }
+
+
+  template <int N, typename T, template <typename> class Alloc>
+  T norm2(const Lattice<MatrixArray<N, 1, T>, Alloc>& field)
+  {
+    T ret = 0.0;
+    for (unsigned long i = 0; i < field.size(); ++i) {
+      for (unsigned long alpha = 0; alpha < field[i].size(); ++alpha) {
+        ret += field[i][alpha].squaredNorm();
+      }
+    }
+    return ret;
+  }
+
+
+  namespace detail
+  {
+    // y += a * x, the solver workhorse update
+    template <typename Field, typename Scalar>
+    void axpy(const Scalar& a, const Field& x, Field& y)
+    {
+      for (unsigned long i = 0; i < y.size(); ++i) {
+        for (unsigned long alpha = 0; alpha < y[i].size(); ++alpha) {
+          y[i][alpha] += a * x[i][alpha];
+        }
+      }
+    }
+
+    // y = x + b * y
+    template <typename Field, typename Scalar>
+    void xpby(const Field& x, const Scalar& b, Field& y)
+    {
+      for (unsigned long i = 0; i < y.size(); ++i) {
+        for (unsigned long alpha = 0; alpha < y[i].size(); ++alpha) {
+          y[i][alpha] = x[i][alpha] + b * y[i][alpha];
+        }
+      }
+    }
+  }
+
+
+  // Solve op * solution = rhs for a hermitian positive-definite op, starting
+  // from the supplied solution guess
+  template <typename Op, typename Field, typename Real>
+  SolverResults<Real> conjugate_gradient(
+    const Op& op, const Field& rhs, Field& solution,
+    const unsigned int max_iterations, const Real tolerance)
+  {
+    typedef std::complex<Real> Complex;
+    SolverResults<Real> results{0, 0.0, {}, 0.0};
+    auto start = std::chrono::steady_clock::now();
+
+    const Real rhs_norm = std::sqrt(norm2(rhs));
+    Field r = rhs;
+    Field ap = rhs;
+    op.apply(ap, solution);
+    detail::axpy(Complex(-1.0), ap, r);
+    Field p = r;
+    Real r_norm2 = norm2(r);
+
+    while (results.iterations < max_iterations) {
+      op.apply(ap, p);
+      const Complex alpha = Complex(r_norm2) / dot(p, ap);
+      detail::axpy(alpha, p, solution);
+      detail::axpy(-alpha, ap, r);
+      const Real r_norm2_new = norm2(r);
+      results.iterations++;
+      results.residuals.push_back(std::sqrt(r_norm2_new) / rhs_norm);
+      if (results.residuals.back() < tolerance) {
+        break;
+      }
+      detail::xpby(r, Complex(r_norm2_new / r_norm2), p);
+      r_norm2 = r_norm2_new;
+    }
+
+    results.final_residual = results.residuals.empty()
+      ? std::sqrt(r_norm2) / rhs_norm : results.residuals.back();
+    results.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    return results;
+  }
+
+
+  // Solve op * solution = rhs for a general op, starting from the supplied
+  // solution guess
+  template <typename Op, typename Field, typename Real>
+  SolverResults<Real> bicgstab(
+    const Op& op, const Field& rhs, Field& solution,
+    const unsigned int max_iterations, const Real tolerance)
+  {
+    typedef std::complex<Real> Complex;
+    SolverResults<Real> results{0, 0.0, {}, 0.0};
+    auto start = std::chrono::steady_clock::now();
+
+    const Real rhs_norm = std::sqrt(norm2(rhs));
+    Field r = rhs;
+    Field v = rhs;
+    op.apply(v, solution);
+    detail::axpy(Complex(-1.0), v, r);
+    const Field r0 = r;
+    Field p = r;
+    Field t = r;
+    Complex rho = dot(r0, r);
+
+    while (results.iterations < max_iterations) {
+      op.apply(v, p);
+      const Complex alpha = rho / dot(r0, v);
+      detail::axpy(-alpha, v, r);          // r is now the intermediate s
+      op.apply(t, r);
+      const Complex omega = dot(t, r) / Complex(norm2(t));
+      detail::axpy(alpha, p, solution);
+      detail::axpy(omega, r, solution);
+      detail::axpy(-omega, t, r);
+      results.iterations++;
+      results.residuals.push_back(std::sqrt(norm2(r)) / rhs_norm);
+      if (results.residuals.back() < tolerance) {
+        break;
+      }
+      const Complex rho_new = dot(r0, r);
+      const Complex beta = (rho_new / rho) * (alpha / omega);
+      rho = rho_new;
+      // p = r + beta * (p - omega * v)
+      detail::axpy(-omega, v, p);
+      detail::xpby(r, beta, p);
+    }
+
+    results.final_residual = results.residuals.empty()
+      ? 1.0 : results.residuals.back();
+    results.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    return results;
+  }
+}
+
+#endif
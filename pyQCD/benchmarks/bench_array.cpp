@@ -1,4 +1,5 @@
-/* Benchmark for Array type. */
+/* Benchmark for Array type, across problem sizes spanning the
+ * cache-resident and memory-bound regimes. */
 
 #include <Eigen/Dense>
 
@@ -9,54 +10,54 @@
 
 template <typename T, template <typename> class Alloc = std::allocator>
 void profile_for_type(const T& elem, const std::string& type,
-  const int add_flops, const int multiply_flops)
+  const int add_flops, const int multiply_flops,
+  std::vector<BenchmarkResult>& results)
 {
   std::cout << "Profiling for array type " << type << "." << std::endl;
-  int n = 100;
-  pyQCD::Array<T, Alloc> array1(n, elem);
-  decltype(array1) array2(n, elem);
-  decltype(array1) array3(n, elem);
-  decltype(array1) result(n, elem);
-
-  std::cout << "Profiling f(x, y, z) = x + y + z:" << std::endl;
-  benchmark([&] () {
-    result = array1 + array2 + array3;
-  }, 2 * add_flops * n, 1000000);
-
-  std::cout << "Profiling f(x, y) = 5.0 * x + y:" << std::endl;
-  benchmark([&] () {
-    result = 5.0 * array1 + array2;
-  }, 2 * add_flops * n, 1000000);
-
-  std::cout << "Profiling f(x, y, z) = x * y + z:" << std::endl;
-  benchmark([&] () {
-    result = array1 * array2 + array3;
-  }, (add_flops + multiply_flops) * n, 1000000);
-  
+  for (unsigned long n : std::vector<unsigned long>{100, 10000, 1000000}) {
+    pyQCD::Array<T, Alloc> array1(n, elem);
+    decltype(array1) array2(n, elem);
+    decltype(array1) array3(n, elem);
+    decltype(array1) result(n, elem);
+    const std::string suffix = "<" + type + ">/" + std::to_string(n);
+
+    results.push_back(benchmark("x + y + z" + suffix, [&] () {
+      result = array1 + array2 + array3;
+    }, 2 * add_flops * n, n));
+
+    results.push_back(benchmark("5.0 * x + y" + suffix, [&] () {
+      result = 5.0 * array1 + array2;
+    }, 2 * add_flops * n, n));
+
+    results.push_back(benchmark("x * y + z" + suffix, [&] () {
+      result = array1 * array2 + array3;
+    }, (add_flops + multiply_flops) * n, n));
+  }
   std::cout << std::endl;
 }
 
 
 int main(int argc, char* argv[])
 {
-  profile_for_type(1.0, "double", 2, 2);
+  std::vector<BenchmarkResult> results;
+  profile_for_type(1.0, "double", 2, 2, results);
   profile_for_type(std::complex<double>(1.0, 0.0), "std::complex<double>",
-                   4, 12);
+                   4, 12, results);
   profile_for_type<Eigen::Matrix2d, Eigen::aligned_allocator>(
     Eigen::Matrix2d::Random(), "Eigen::Matrix2d",
-    matadd_flops(2, false, 2), matmul_flops(2, false, 2)
+    matadd_flops(2, false, 2), matmul_flops(2, false, 2), results
   );
   profile_for_type<Eigen::Matrix4d, Eigen::aligned_allocator>(
     Eigen::Matrix4d::Random(), "Eigen::Matrix4d",
-    matadd_flops(4, false, 2), matmul_flops(4, false, 2)
+    matadd_flops(4, false, 2), matmul_flops(4, false, 2), results
   );
   profile_for_type<Eigen::Matrix2cd, Eigen::aligned_allocator>(
     Eigen::Matrix2cd::Random(), "Eigen::Matrix2cd",
-    matadd_flops(2, true, 2), matmul_flops(2, true, 2)
+    matadd_flops(2, true, 2), matmul_flops(2, true, 2), results
   );
   profile_for_type<Eigen::Matrix3cd, Eigen::aligned_allocator>(
     Eigen::Matrix3cd::Random(), "Eigen::Matrix3cd",
-    matadd_flops(3, true, 2), matmul_flops(3, true, 2)
+    matadd_flops(3, true, 2), matmul_flops(3, true, 2), results
   );
-  return 0;
+  return finish_benchmark(results, argc, argv);
 }
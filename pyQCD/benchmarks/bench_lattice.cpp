@@ -0,0 +1,93 @@
+/* Benchmarks for lattice-scale hot paths: site access through each Layout,
+ * stencil gathers via the neighbour tables, and arithmetic on SU(3)-valued
+ * lattices. */
+
+#include <Eigen/Dense>
+
+#include "helpers.hpp"
+
+#include <core/lattice.hpp>
+
+
+template <typename Layout>
+void profile_site_access(const std::string& layout_name,
+  const std::vector<unsigned int>& shape,
+  std::vector<BenchmarkResult>& results)
+{
+  Layout layout(shape);
+  pyQCD::Lattice<double> lattice(layout, 1.0);
+  const unsigned int volume = layout.volume();
+  const std::string suffix = "<" + layout_name + ">/"
+    + std::to_string(volume);
+  double sink = 0.0;
+
+  results.push_back(benchmark("site access by index" + suffix, [&] () {
+    for (unsigned int i = 0; i < volume; ++i) {
+      sink += lattice(i);
+    }
+  }, 0, volume));
+
+  std::vector<std::vector<unsigned int> > sites(volume,
+    std::vector<unsigned int>(shape.size()));
+  for (unsigned int i = 0; i < volume; ++i) {
+    unsigned int remainder = i;
+    for (unsigned int d = shape.size(); d-- > 0;) {
+      sites[i][d] = remainder % shape[d];
+      remainder /= shape[d];
+    }
+  }
+  results.push_back(benchmark("site access by coords" + suffix, [&] () {
+    for (unsigned int i = 0; i < volume; ++i) {
+      sink += lattice(sites[i]);
+    }
+  }, 0, volume));
+
+  results.push_back(benchmark("gather" + suffix, [&] () {
+    pyQCD::Lattice<double> shifted = lattice.gather(0, 0);
+    sink += shifted[0];
+  }, 0, volume));
+
+  if (sink == 42.0) {  // defeat dead-code elimination
+    std::cout << sink;
+  }
+}
+
+
+void profile_su3(const std::vector<unsigned int>& shape,
+                 std::vector<BenchmarkResult>& results)
+{
+  pyQCD::LexicoLayout layout(shape);
+  typedef pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+    GaugeField;
+  GaugeField field1(layout, Eigen::Matrix3cd::Random());
+  GaugeField field2(layout, Eigen::Matrix3cd::Random());
+  GaugeField result(layout, Eigen::Matrix3cd::Zero());
+  const unsigned int volume = layout.volume();
+  const std::string suffix = "<Matrix3cd>/" + std::to_string(volume);
+
+  results.push_back(benchmark("lattice U * V" + suffix, [&] () {
+    result = field1 * field2;
+  }, static_cast<long>(matmul_flops(3, true, 2)) * volume, volume));
+
+  results.push_back(benchmark("lattice U + V" + suffix, [&] () {
+    result = field1 + field2;
+  }, static_cast<long>(matadd_flops(3, true, 2)) * volume, volume));
+
+  results.push_back(benchmark("lattice copy" + suffix, [&] () {
+    result = field1;
+  }, 0, volume));
+}
+
+
+int main(int argc, char* argv[])
+{
+  std::vector<BenchmarkResult> results;
+  for (unsigned int length : std::vector<unsigned int>{8, 16}) {
+    std::vector<unsigned int> shape{2 * length, length, length, length};
+    profile_site_access<pyQCD::LexicoLayout>("LexicoLayout", shape, results);
+    profile_site_access<pyQCD::EvenOddLayout>("EvenOddLayout", shape,
+                                              results);
+    profile_su3(shape, results);
+  }
+  return finish_benchmark(results, argc, argv);
+}
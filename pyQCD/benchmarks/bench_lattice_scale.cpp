@@ -0,0 +1,181 @@
+/* Benchmarks for lattice-scale hot paths at production volumes: expression
+ * assignment through Lattice::operator=, coordinate vs index site access
+ * through each Layout, same-layout and cross-layout copy/assignment, and
+ * arithmetic on SU(3)-valued lattices. Run with --compare against a stored
+ * baseline to fail loudly on a throughput regression. */
+
+#include <Eigen/Dense>
+
+#include "helpers.hpp"
+
+#include <core/lattice.hpp>
+
+
+namespace
+{
+  std::string shape_string(const std::vector<unsigned int>& shape)
+  {
+    std::string ret;
+    for (unsigned int i = 0; i < shape.size(); ++i) {
+      ret += (i > 0 ? "x" : "") + std::to_string(shape[i]);
+    }
+    return ret;
+  }
+}
+
+
+void profile_expression_assignment(const std::vector<unsigned int>& shape,
+                                   std::vector<BenchmarkResult>& results)
+{
+  pyQCD::LexicoLayout layout(shape);
+  const unsigned int volume = layout.volume();
+  pyQCD::Lattice<double> field1(layout, 1.0), field2(layout, 2.0),
+    field3(layout, 3.0), result(layout, 0.0);
+  const std::string suffix = "<double>/" + shape_string(shape);
+
+  results.push_back(benchmark("lattice x + y + z" + suffix, [&] () {
+    result = field1 + field2 + field3;
+  }, 2L * volume, volume));
+
+  results.push_back(benchmark("lattice 5.0 * x + y" + suffix, [&] () {
+    result = 5.0 * field1 + field2;
+  }, 2L * volume, volume));
+
+  results.push_back(benchmark("lattice x * y + z" + suffix, [&] () {
+    result = field1 * field2 + field3;
+  }, 2L * volume, volume));
+}
+
+
+void profile_copy_assignment(const std::vector<unsigned int>& shape,
+                             std::vector<BenchmarkResult>& results)
+{
+  pyQCD::LexicoLayout lexico_layout(shape);
+  pyQCD::EvenOddLayout even_odd_layout(shape);
+  const unsigned int volume = lexico_layout.volume();
+  pyQCD::Lattice<double> source(lexico_layout, 1.0);
+  pyQCD::Lattice<double> same_layout(lexico_layout, 0.0);
+  pyQCD::Lattice<double> other_layout(even_odd_layout, 0.0);
+  const std::string suffix = "<double>/" + shape_string(shape);
+
+  // Same layout object: operator= takes the contiguous fast path
+  results.push_back(benchmark("lattice copy same layout" + suffix, [&] () {
+    same_layout = source;
+  }, 0, volume));
+
+  // Different layout objects: operator= translates site by site
+  results.push_back(benchmark("lattice copy cross layout" + suffix, [&] () {
+    other_layout = source;
+  }, 0, volume));
+}
+
+
+template <typename LayoutType>
+void profile_site_access(const std::string& layout_name,
+  const LayoutType& layout, std::vector<BenchmarkResult>& results)
+{
+  pyQCD::Lattice<double, std::allocator, LayoutType> lattice(layout, 1.0);
+  const unsigned int volume = layout.volume();
+  const std::vector<unsigned int>& shape = layout.shape();
+  const std::string suffix = "<" + layout_name + ">/"
+    + shape_string(shape);
+  double sink = 0.0;
+
+  results.push_back(benchmark("site access by index" + suffix, [&] () {
+    for (unsigned int i = 0; i < volume; ++i) {
+      sink += lattice(i);
+    }
+  }, 0, volume));
+
+  std::vector<std::vector<unsigned int> > sites(volume,
+    std::vector<unsigned int>(shape.size()));
+  for (unsigned int i = 0; i < volume; ++i) {
+    unsigned int remainder = i;
+    for (unsigned int d = shape.size(); d-- > 0;) {
+      sites[i][d] = remainder % shape[d];
+      remainder /= shape[d];
+    }
+  }
+  results.push_back(benchmark("site access by coords" + suffix, [&] () {
+    for (unsigned int i = 0; i < volume; ++i) {
+      sink += lattice(sites[i]);
+    }
+  }, 0, volume));
+
+  if (sink == 42.0) {  // defeat dead-code elimination
+    std::cout << sink;
+  }
+}
+
+
+void profile_su3(const std::vector<unsigned int>& shape,
+                 std::vector<BenchmarkResult>& results)
+{
+  pyQCD::LexicoLayout layout(shape);
+  typedef pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+    GaugeField;
+  GaugeField field1(layout, Eigen::Matrix3cd::Random());
+  GaugeField field2(layout, Eigen::Matrix3cd::Random());
+  GaugeField result(layout, Eigen::Matrix3cd::Zero());
+  const unsigned int volume = layout.volume();
+  const std::string suffix = "<Matrix3cd>/" + shape_string(shape);
+
+  results.push_back(benchmark("lattice U * V" + suffix, [&] () {
+    result = field1 * field2;
+  }, static_cast<long>(matmul_flops(3, true, 2)) * volume, volume));
+
+  results.push_back(benchmark("lattice U + V" + suffix, [&] () {
+    result = field1 + field2;
+  }, static_cast<long>(matadd_flops(3, true, 2)) * volume, volume));
+
+  results.push_back(benchmark("lattice U * V + W" + suffix, [&] () {
+    result = field1 * field2 + field1;
+  }, static_cast<long>(matmul_flops(3, true, 2)
+                       + matadd_flops(3, true, 2)) * volume, volume));
+
+  results.push_back(benchmark("lattice copy" + suffix, [&] () {
+    result = field1;
+  }, 0, volume));
+}
+
+
+int main(int argc, char* argv[])
+{
+  std::vector<BenchmarkResult> results;
+
+  // Scalar fields cover the full production range up to 48^3x96; SU(3)
+  // fields stop at 32^3x64 to keep the three live Matrix3cd lattices
+  // within a single node's memory
+  const std::vector<std::vector<unsigned int> > scalar_shapes{
+    {16, 16, 16, 16}, {48, 24, 24, 24}, {64, 32, 32, 32}, {96, 48, 48, 48}};
+  for (const std::vector<unsigned int>& shape : scalar_shapes) {
+    profile_expression_assignment(shape, results);
+    profile_copy_assignment(shape, results);
+  }
+  for (const std::vector<unsigned int>& shape :
+       std::vector<std::vector<unsigned int> >{{16, 16, 16, 16},
+                                               {64, 32, 32, 32}}) {
+    profile_su3(shape, results);
+  }
+
+  // Coordinate vs index access through each layout at a representative
+  // volume; the static layouts resolve their indexing at compile time via
+  // the Lattice's layout template parameter
+  const std::vector<unsigned int> access_shape{64, 32, 32, 32};
+  profile_site_access("LexicoLayout", pyQCD::LexicoLayout(access_shape),
+                      results);
+  profile_site_access("StaticLexicoLayout",
+                      pyQCD::StaticLexicoLayout(access_shape), results);
+  profile_site_access("FixedLexicoLayout<4>",
+                      pyQCD::FixedLexicoLayout<4>(access_shape), results);
+  profile_site_access("ConstShapeLexicoLayout",
+                      pyQCD::ConstShapeLexicoLayout<64, 32, 32, 32>(),
+                      results);
+  profile_site_access("EvenOddLayout", pyQCD::EvenOddLayout(access_shape),
+                      results);
+  profile_site_access("TiledLayout",
+                      pyQCD::TiledLayout(access_shape,
+                        std::vector<unsigned int>{4, 4, 4, 4}), results);
+
+  return finish_benchmark(results, argc, argv);
+}
@@ -1,10 +1,24 @@
 #ifndef HELPERS_HPP
 #define HELPERS_HPP
 
-/* Utilities to facilitate benchmarking */
+/* Utilities to facilitate benchmarking. benchmark() times a callable with
+ * warm-up and repeated measurement on a steady clock and reports
+ * median/mean/stddev per call, so results are stable enough to gate
+ * upgrades on. Results can be dumped as CSV or JSON for regression
+ * tracking, and a stored CSV can be replayed as a baseline: a run whose
+ * medians slip past the tolerance exits non-zero so CI fails loudly.
+ */
 
-#include <iostream>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
 
 unsigned int matmul_flops(
   const unsigned int n, const bool complex, const unsigned int float_width)
@@ -22,27 +36,244 @@ unsigned int matadd_flops(
 }
 
 
+struct BenchmarkResult
+{
+  std::string name;
+  unsigned long problem_size;  // elements/sites, for scaling comparisons
+  unsigned int num_repetitions;
+  double median;               // seconds per call
+  double mean;
+  double stddev;
+  double minimum;
+  long num_flops;              // flops per call, 0 if not applicable
+
+  double mflops() const
+  { return num_flops > 0 ? num_flops / median / 1.0e6 : 0.0; }
+};
+
+
 template <typename Fn>
-void benchmark(Fn func, const long num_flops = 0, const int num_trials = 100)
+BenchmarkResult benchmark(const std::string& name, Fn func,
+  const long num_flops = 0, const unsigned long problem_size = 0,
+  const unsigned int num_repetitions = 10)
 {
-  auto start = std::chrono::system_clock::now();
-  for (int i = 0; i < num_trials; ++i) {
+  typedef std::chrono::steady_clock Clock;
+
+  // Calibrate the number of calls per repetition so each repetition runs
+  // for roughly 10 ms, then discard one warm-up repetition
+  auto start = Clock::now();
+  func();
+  double single_call
+    = std::chrono::duration<double>(Clock::now() - start).count();
+  const unsigned long calls_per_rep = single_call > 0.01
+    ? 1 : static_cast<unsigned long>(0.01 / (single_call + 1.0e-9)) + 1;
+  for (unsigned long i = 0; i < calls_per_rep; ++i) {
     func();
   }
-  auto end = std::chrono::system_clock::now();
 
-  std::chrono::duration<double> elapsed_seconds = end - start;
-  double elapsed = elapsed_seconds.count();
-  std::cout << "Performed " << num_flops * num_trials << " flops in " << elapsed
-    << " seconds";
+  std::vector<double> timings(num_repetitions);
+  for (unsigned int rep = 0; rep < num_repetitions; ++rep) {
+    start = Clock::now();
+    for (unsigned long i = 0; i < calls_per_rep; ++i) {
+      func();
+    }
+    timings[rep] = std::chrono::duration<double>(Clock::now() - start).count()
+      / calls_per_rep;
+  }
+
+  std::sort(timings.begin(), timings.end());
+  BenchmarkResult result;
+  result.name = name;
+  result.problem_size = problem_size;
+  result.num_repetitions = num_repetitions;
+  result.median = (num_repetitions % 2 == 0)
+    ? 0.5 * (timings[num_repetitions / 2 - 1] + timings[num_repetitions / 2])
+    : timings[num_repetitions / 2];
+  result.minimum = timings.front();
+  result.mean = 0.0;
+  for (double t : timings) {
+    result.mean += t;
+  }
+  result.mean /= num_repetitions;
+  result.stddev = 0.0;
+  for (double t : timings) {
+    result.stddev += (t - result.mean) * (t - result.mean);
+  }
+  result.stddev = std::sqrt(result.stddev / num_repetitions);
+  result.num_flops = num_flops;
 
+  std::cout << result.name << ": median " << result.median * 1.0e6
+    << " us/call (stddev " << result.stddev * 1.0e6 << " us)";
   if (num_flops > 0) {
-    std::cout << " => " << num_trials * num_flops / elapsed / 1000000.0
-      << " Mflops." << std::endl;
+    std::cout << " => " << result.mflops() << " Mflops";
+  }
+  std::cout << std::endl;
+  return result;
+}
+
+
+inline void write_results_csv(const std::vector<BenchmarkResult>& results,
+                              std::ostream& stream)
+{
+  stream << "name,problem_size,repetitions,median,mean,stddev,min,"
+         << "flops,mflops\n";
+  for (const BenchmarkResult& result : results) {
+    stream << result.name << "," << result.problem_size << ","
+      << result.num_repetitions << "," << result.median << ","
+      << result.mean << "," << result.stddev << "," << result.minimum << ","
+      << result.num_flops << "," << result.mflops() << "\n";
+  }
+}
+
+
+inline void write_results_json(const std::vector<BenchmarkResult>& results,
+                               std::ostream& stream)
+{
+  stream << "[\n";
+  for (unsigned long i = 0; i < results.size(); ++i) {
+    const BenchmarkResult& result = results[i];
+    stream << "  {\"name\": \"" << result.name << "\", "
+      << "\"problem_size\": " << result.problem_size << ", "
+      << "\"repetitions\": " << result.num_repetitions << ", "
+      << "\"median\": " << result.median << ", "
+      << "\"mean\": " << result.mean << ", "
+      << "\"stddev\": " << result.stddev << ", "
+      << "\"min\": " << result.minimum << ", "
+      << "\"flops\": " << result.num_flops << ", "
+      << "\"mflops\": " << result.mflops() << "}"
+      << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  stream << "]\n";
+}
+
+
+// Parse results back from the CSV produced by write_results_csv, for use
+// as a regression baseline
+inline std::vector<BenchmarkResult> read_results_csv(std::istream& stream)
+{
+  std::vector<BenchmarkResult> results;
+  std::string line;
+  std::getline(stream, line);  // header
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    std::string field;
+    std::vector<std::string> values;
+    while (std::getline(fields, field, ',')) {
+      values.push_back(field);
+    }
+    if (values.size() < 8) {
+      continue;
+    }
+    BenchmarkResult result;
+    result.name = values[0];
+    result.problem_size = std::strtoul(values[1].c_str(), nullptr, 10);
+    result.num_repetitions
+      = static_cast<unsigned int>(std::strtoul(values[2].c_str(), nullptr,
+                                               10));
+    result.median = std::atof(values[3].c_str());
+    result.mean = std::atof(values[4].c_str());
+    result.stddev = std::atof(values[5].c_str());
+    result.minimum = std::atof(values[6].c_str());
+    result.num_flops = std::atol(values[7].c_str());
+    results.push_back(result);
+  }
+  return results;
+}
+
+
+// Compare a fresh run against a stored baseline by name, flagging every
+// benchmark whose median exceeds its baseline median by more than the
+// fractional tolerance. Returns the number of regressions; benchmarks
+// missing from the baseline are reported but do not fail the run.
+inline int compare_results(const std::vector<BenchmarkResult>& results,
+                           const std::vector<BenchmarkResult>& baseline,
+                           const double tolerance)
+{
+  int num_regressions = 0;
+  for (const BenchmarkResult& result : results) {
+    const BenchmarkResult* base = nullptr;
+    for (const BenchmarkResult& candidate : baseline) {
+      if (candidate.name == result.name) {
+        base = &candidate;
+        break;
+      }
+    }
+    if (base == nullptr) {
+      std::cout << "NO BASELINE: " << result.name << std::endl;
+      continue;
+    }
+    const double ratio = result.median / base->median;
+    if (ratio > 1.0 + tolerance) {
+      std::cerr << "REGRESSION: " << result.name << " median "
+        << result.median * 1.0e6 << " us/call vs baseline "
+        << base->median * 1.0e6 << " us/call (" << (ratio - 1.0) * 100.0
+        << "% slower)" << std::endl;
+      ++num_regressions;
+    }
+    else {
+      std::cout << "ok: " << result.name << " ("
+        << (ratio - 1.0) * 100.0 << "% vs baseline)" << std::endl;
+    }
+  }
+  return num_regressions;
+}
+
+
+// Shared command-line handling for benchmark executables:
+//
+//   bench_foo [results-file] [--compare baseline.csv] [--tolerance 0.25]
+//
+// A positional argument names a results file, written as JSON when the name
+// ends in .json and CSV otherwise. --compare replays a stored CSV as a
+// baseline and makes the process exit non-zero on any regression beyond the
+// tolerance, so CI can gate on the return value of main().
+inline int finish_benchmark(const std::vector<BenchmarkResult>& results,
+                            const int argc, char* argv[])
+{
+  std::string results_file, baseline_file;
+  double tolerance = 0.25;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (arg == "--compare" and i + 1 < argc) {
+      baseline_file = argv[++i];
+    }
+    else if (arg == "--tolerance" and i + 1 < argc) {
+      tolerance = std::atof(argv[++i]);
+    }
+    else {
+      results_file = arg;
+    }
   }
-  else {
-    std::cout << "." << std::endl;
+
+  if (not results_file.empty()) {
+    std::ofstream file(results_file.c_str());
+    if (results_file.size() > 5
+        and results_file.substr(results_file.size() - 5) == ".json") {
+      write_results_json(results, file);
+    }
+    else {
+      write_results_csv(results, file);
+    }
+  }
+
+  if (not baseline_file.empty()) {
+    std::ifstream file(baseline_file.c_str());
+    if (not file.good()) {
+      std::cerr << "Cannot open baseline file " << baseline_file
+        << std::endl;
+      return 1;
+    }
+    const std::vector<BenchmarkResult> baseline = read_results_csv(file);
+    const int num_regressions = compare_results(results, baseline, tolerance);
+    if (num_regressions > 0) {
+      std::cerr << num_regressions << " benchmark(s) regressed beyond "
+        << tolerance * 100.0 << "% tolerance" << std::endl;
+      return 1;
+    }
+    std::cout << "All benchmarks within " << tolerance * 100.0
+      << "% of baseline" << std::endl;
   }
+  return 0;
 }
 
 #endif
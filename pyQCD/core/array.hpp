@@ -15,11 +15,15 @@
 
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <utils/instrumentation.hpp>
 #include <utils/macros.hpp>
 #include <utils/templates.hpp>
+#include <utils/thread_pool.hpp>
 #include "detail/array_expr.hpp"
+#include "detail/reductions.hpp"
 
 
 namespace pyQCD
@@ -41,9 +45,10 @@ namespace pyQCD
     {
       data_.resize(expr.size());
       T1* ptr = &data_[0];
-      for (unsigned long i = 0; i < expr.size(); ++i) {
-        ptr[i] = static_cast<T1>(expr[i]);
-      }
+      const unsigned long size = expr.size();
+      PYQCD_SCOPED_KERNEL("Array(expr)", 2 * size * sizeof(T1), 0);
+      parallel_for(size, [ptr, &expr] (const unsigned long i)
+        { ptr[i] = static_cast<T1>(expr[i]); });
     }
     virtual ~Array() = default;
 
@@ -54,11 +59,13 @@ namespace pyQCD
     ArrayConst<Array<T1, Alloc, T2> > broadcast() const
     { return ArrayConst<Array<T1, Alloc, T2> >(*this); }
 
-    typename std::vector<T1>::iterator begin() { return data_.begin(); }
-    typename std::vector<T1>::const_iterator begin() const
+    typename std::vector<T1, Alloc<T1> >::iterator begin()
     { return data_.begin(); }
-    typename std::vector<T1>::iterator end() { return data_.end(); }
-    typename std::vector<T1>::const_iterator end() const { return data_.end(); }
+    typename std::vector<T1, Alloc<T1> >::const_iterator begin() const
+    { return data_.begin(); }
+    typename std::vector<T1, Alloc<T1> >::iterator end() { return data_.end(); }
+    typename std::vector<T1, Alloc<T1> >::const_iterator end() const
+    { return data_.end(); }
 
     Array<T1, Alloc, T2>& operator=(const Array<T1, Alloc, T2>& array) = default;
     Array<T1, Alloc, T2>& operator=(Array<T1, Alloc, T2>&& array) = default;
@@ -73,9 +80,11 @@ namespace pyQCD
       pyQCDassert ((data_.size() == expr.size()),
                    std::out_of_range("Array::data_"));
       T1* ptr = &data_[0];
-      for (unsigned long i = 0; i < expr.size(); ++i) {
-        ptr[i] = static_cast<T1>(expr[i]);
-      }
+      const unsigned long size = expr.size();
+      PYQCD_SCOPED_KERNEL("Array::operator=(expr)", 2 * size * sizeof(T1),
+                          0);
+      parallel_for(size, [ptr, &expr] (const unsigned long i)
+        { ptr[i] = static_cast<T1>(expr[i]); });
       return *this;
     }
 
@@ -94,6 +103,8 @@ namespace pyQCD
 
     unsigned long size() const { return data_.size(); }
 
+    void swap(Array<T1, Alloc, T2>& other) { data_.swap(other.data_); }
+
   protected:
     std::vector<T1, Alloc<T1> > data_;
   };
@@ -106,9 +117,9 @@ namespace pyQCD
       not std::is_base_of<ArrayObj, U>::value>::type*>                      \
   Array<T1, Alloc, T2>& Array<T1, Alloc, T2>::operator op ## =(const U& rhs)\
   {                                                                         \
-    for (auto& item : data_) {                                              \
-      item op ## = rhs;                                                     \
-    }                                                                       \
+    T1* ptr = &data_[0];                                                    \
+    parallel_for(data_.size(), [ptr, &rhs] (const unsigned long i)          \
+      { ptr[i] op ## = rhs; });                                             \
     return *this;                                                           \
   }                                                                         \
                                                                             \
@@ -120,9 +131,9 @@ namespace pyQCD
   {                                                                         \
     pyQCDassert (rhs.size() == data_.size(),                                \
       std::out_of_range("Arrays must be the same size"));                   \
-    for (unsigned long i = 0; i < data_.size(); ++i) {                      \
-      data_[i] op ## = rhs[i];                                              \
-    }                                                                       \
+    T1* ptr = &data_[0];                                                    \
+    parallel_for(data_.size(), [ptr, &rhs] (const unsigned long i)          \
+      { ptr[i] op ## = rhs[i]; });                                          \
     return *this;                                                           \
   }
 
@@ -130,6 +141,38 @@ namespace pyQCD
   ARRAY_OPERATOR_ASSIGN_IMPL(-);
   ARRAY_OPERATOR_ASSIGN_IMPL(*);
   ARRAY_OPERATOR_ASSIGN_IMPL(/);
+
+
+  // When the left-hand operand is an expiring Array its buffer is reused for
+  // the result via the compound assignment operators, rather than building an
+  // expression that a fresh Array is later allocated for. Overload resolution
+  // prefers these for rvalues; lvalue operands still go through the
+  // expression templates above.
+#define ARRAY_MOVE_OPERATOR(op)                                             \
+  template <typename T1, template <typename> class Alloc, typename U>       \
+  Array<T1, Alloc, EmptyType>                                               \
+  operator op(Array<T1, Alloc, EmptyType>&& lhs,                            \
+              const Array<U, Alloc, EmptyType>& rhs)                        \
+  {                                                                         \
+    lhs op ## = rhs;                                                        \
+    return std::move(lhs);                                                  \
+  }                                                                         \
+                                                                            \
+                                                                            \
+  template <typename T1, template <typename> class Alloc, typename U,       \
+    typename std::enable_if<                                                \
+      not std::is_base_of<ArrayObj, U>::value>::type* = nullptr>            \
+  Array<T1, Alloc, EmptyType>                                               \
+  operator op(Array<T1, Alloc, EmptyType>&& lhs, const U& rhs)              \
+  {                                                                         \
+    lhs op ## = rhs;                                                        \
+    return std::move(lhs);                                                  \
+  }
+
+  ARRAY_MOVE_OPERATOR(+);
+  ARRAY_MOVE_OPERATOR(-);
+  ARRAY_MOVE_OPERATOR(*);
+  ARRAY_MOVE_OPERATOR(/);
 }
 
 #endif
@@ -51,7 +51,11 @@ namespace pyQCD
   class ArrayConst
     : public ArrayExpr<ArrayConst<T>, T>
   {
-    // Expression subclass for const operations
+    // Expression subclass for const operations. Small trivially copyable
+    // scalars are captured by value, so the innermost loop reads them from a
+    // register-friendly member instead of chasing a pointer, and expiring
+    // temporaries (e.g. the 5.0 in 5.0 * array) cannot dangle. Larger
+    // operands such as broadcast matrices keep reference semantics.
   public:
     // Need some SFINAE here to ensure no clash with copy/move constructor
     template <typename std::enable_if<
@@ -60,7 +64,11 @@ namespace pyQCD
     const T& operator[](const unsigned long i) const { return scalar_; }
 
   private:
-    const T& scalar_;
+    typedef typename std::conditional<
+      std::is_trivially_copyable<T>::value
+        and sizeof(T) <= 2 * sizeof(double),
+      const T, const T&>::type storage_type;
+    storage_type scalar_;
   };
 
 
@@ -83,6 +91,48 @@ namespace pyQCD
   };
 
 
+  template <typename T1, typename T2>
+  class ArrayShift
+    : public ArrayExpr<ArrayShift<T1, T2>, T2>
+  {
+    // Expression subclass remapping site indices through the Layout neighbour
+    // relation, so that e.g. U * shift(psi, mu, 0) evaluates the hopping term
+    // in a single pass over memory without materializing a shifted copy of
+    // psi. The operand must carry a Layout (i.e. be or wrap a Lattice).
+  public:
+    ArrayShift(const ArrayExpr<T1, T2>& operand, const unsigned int dim,
+               const unsigned int direction)
+      : operand_(operand), layout_(operand.layout()), dim_(dim),
+        direction_(direction)
+    {
+      pyQCDassert((layout_ != nullptr),
+        std::invalid_argument("ArrayShift: operand has no layout"));
+    }
+
+    const T2 operator[](const unsigned long i) const
+    { return operand_[layout_->get_neighbour_index(i, dim_, direction_)]; }
+
+    unsigned long size() const { return operand_.size(); }
+    const Layout* layout() const { return layout_; }
+
+  private:
+    typename OperandTraits<T1>::type operand_;
+    const Layout* layout_;
+    unsigned int dim_, direction_;
+  };
+
+
+  // Build a lazily shifted view of expr: shift(expr, dim, 0) evaluates at
+  // site x to expr at x + one unit along dim (0 for the positive shift, 1 for
+  // the negative one), with periodic wrapping.
+  template <typename T1, typename T2>
+  const ArrayShift<T1, T2> shift(const ArrayExpr<T1, T2>& expr,
+    const unsigned int dim, const unsigned int direction)
+  {
+    return ArrayShift<T1, T2>(expr, dim, direction);
+  }
+
+
   template <typename T1, typename T2, typename T3, typename T4, typename Op>
   class ArrayBinary
     : public ArrayExpr<ArrayBinary<T1, T2, T3, T4, Op>,
@@ -13,7 +13,7 @@ namespace pyQCD
   template <typename T>
   class ArrayConst;
 
-  template <typename T, template <typename> class Alloc>
+  template <typename T, template <typename> class Alloc, typename L>
   class Lattice;
 
   // These traits classes allow us to switch between a const ref and simple
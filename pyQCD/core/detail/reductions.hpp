@@ -0,0 +1,122 @@
+#ifndef REDUCTIONS_HPP
+#define REDUCTIONS_HPP
+
+/* This file provides reduction terminals for the Array expression templates.
+ * sum, norm2 and dot evaluate their operand expression tree element by
+ * element and accumulate in the same pass, so computing e.g. a solver
+ * residual norm never materializes the elementwise result into a temporary
+ * Array. Above PYQCD_PARALLEL_THRESHOLD elements the accumulation is split
+ * into per-thread partial sums that are combined at the end.
+ */
+
+#include <complex>
+#include <mutex>
+
+#include <utils/macros.hpp>
+#include <utils/thread_pool.hpp>
+
+#include "array_expr.hpp"
+
+
+namespace pyQCD
+{
+  namespace detail
+  {
+    // Single-pass sum of fn(i) for i in [0, size); requires size > 0
+    template <typename T, typename Fn>
+    T reduce(const unsigned long size, Fn fn)
+    {
+      T ret = fn(0);
+      if (size <= PYQCD_PARALLEL_THRESHOLD) {
+        for (unsigned long i = 1; i < size; ++i) {
+          ret = ret + fn(i);
+        }
+        return ret;
+      }
+      // Each pool thread accumulates a contiguous block into a private
+      // partial sum, combined under a mutex once per block
+      std::mutex combine_mutex;
+      ThreadPool::instance().for_blocks(1, size,
+        [&ret, &fn, &combine_mutex] (const unsigned long begin,
+                                     const unsigned long end) {
+          T partial = fn(begin);
+          for (unsigned long i = begin + 1; i < end; ++i) {
+            partial = partial + fn(i);
+          }
+          std::lock_guard<std::mutex> lock(combine_mutex);
+          ret = ret + partial;
+        });
+      return ret;
+    }
+
+    // Squared magnitude of a single element, for scalar, complex and Eigen
+    // operand types
+    inline float norm_squared(const float value) { return value * value; }
+    inline double norm_squared(const double value) { return value * value; }
+    template <typename T>
+    T norm_squared(const std::complex<T>& value) { return std::norm(value); }
+    template <typename T>
+    auto norm_squared(const T& value) -> decltype(value.squaredNorm())
+    { return value.squaredNorm(); }
+
+    // Conjugate product of a pair of elements
+    inline float conjugate_dot(const float lhs, const float rhs)
+    { return lhs * rhs; }
+    inline double conjugate_dot(const double lhs, const double rhs)
+    { return lhs * rhs; }
+    template <typename T>
+    std::complex<T> conjugate_dot(const std::complex<T>& lhs,
+                                  const std::complex<T>& rhs)
+    { return std::conj(lhs) * rhs; }
+    template <typename T1, typename T2>
+    auto conjugate_dot(const T1& lhs, const T2& rhs)
+      -> decltype(lhs.dot(rhs))
+    { return lhs.dot(rhs); }
+  }
+
+
+  // Sum of all elements of the expression, evaluated in one pass
+  template <typename T1, typename T2>
+  T2 sum(const ArrayExpr<T1, T2>& expr)
+  {
+    pyQCDassert ((expr.size() > 0), std::out_of_range("sum: empty expression"));
+    const T1& operand = static_cast<const T1&>(expr);
+    return detail::reduce<T2>(expr.size(),
+      [&operand] (const unsigned long i) { return static_cast<T2>(operand[i]); });
+  }
+
+
+  // Sum of squared element magnitudes, evaluated in one pass
+  template <typename T1, typename T2>
+  auto norm2(const ArrayExpr<T1, T2>& expr)
+    -> decltype(detail::norm_squared(std::declval<T2>()))
+  {
+    typedef decltype(detail::norm_squared(std::declval<T2>())) Real;
+    pyQCDassert ((expr.size() > 0),
+                 std::out_of_range("norm2: empty expression"));
+    const T1& operand = static_cast<const T1&>(expr);
+    return detail::reduce<Real>(expr.size(),
+      [&operand] (const unsigned long i)
+      { return detail::norm_squared(static_cast<T2>(operand[i])); });
+  }
+
+
+  // Conjugate inner product of two expressions, evaluated in one pass
+  template <typename T1, typename T2, typename T3, typename T4>
+  auto dot(const ArrayExpr<T1, T3>& lhs, const ArrayExpr<T2, T4>& rhs)
+    -> decltype(detail::conjugate_dot(std::declval<T3>(), std::declval<T4>()))
+  {
+    typedef decltype(detail::conjugate_dot(std::declval<T3>(),
+                                           std::declval<T4>())) Scalar;
+    pyQCDassert ((lhs.size() == rhs.size() and lhs.size() > 0),
+                 std::out_of_range("dot: lhs.size() != rhs.size()"));
+    const T1& lhs_operand = static_cast<const T1&>(lhs);
+    const T2& rhs_operand = static_cast<const T2&>(rhs);
+    return detail::reduce<Scalar>(lhs.size(),
+      [&lhs_operand, &rhs_operand] (const unsigned long i)
+      { return detail::conjugate_dot(static_cast<T3>(lhs_operand[i]),
+                                     static_cast<T4>(rhs_operand[i])); });
+  }
+}
+
+#endif
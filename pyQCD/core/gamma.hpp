@@ -0,0 +1,58 @@
+#ifndef GAMMA_HPP
+#define GAMMA_HPP
+
+/* This file provides compile-time gamma-matrix algebra in the DeGrand-Rossi
+ * basis (index 0 is the time direction, matching WilsonDiracOperator). Each
+ * gamma matrix has exactly one nonzero entry per row, equal to +/-1 or +/-i,
+ * so it is stored as a constexpr column permutation plus integer real/imag
+ * parts. A spin projection (1 +/- gamma_mu) psi then touches two spinor
+ * components per row instead of running a dense 4x4 complex multiply full of
+ * structural zeros, halving its flop count.
+ */
+
+#include <complex>
+
+#include "matrix_array.hpp"
+
+
+namespace pyQCD
+{
+  namespace gamma
+  {
+    constexpr unsigned int num_spins = 4;
+
+    // gamma_mu(alpha, column[mu][alpha]) = coeff_re[mu][alpha]
+    //   + i coeff_im[mu][alpha]; all other entries vanish
+    constexpr unsigned int column[4][4] = {
+      {2, 3, 0, 1}, {3, 2, 1, 0}, {3, 2, 1, 0}, {2, 3, 0, 1}};
+    constexpr int coeff_re[4][4] = {
+      {1, 1, 1, 1}, {0, 0, 0, 0}, {-1, 1, 1, -1}, {0, 0, 0, 0}};
+    constexpr int coeff_im[4][4] = {
+      {0, 0, 0, 0}, {1, 1, -1, -1}, {0, 0, 0, 0}, {1, -1, -1, 1}};
+
+    template <typename Real>
+    inline std::complex<Real> coefficient(const unsigned int mu,
+                                          const unsigned int alpha)
+    {
+      return std::complex<Real>(coeff_re[mu][alpha], coeff_im[mu][alpha]);
+    }
+
+    // out = (1 + Sign * gamma_Mu) psi, fully specialized per direction so
+    // the compiler folds the permutation and +/-1/i coefficients away
+    template <unsigned int Mu, int Sign, typename Real>
+    inline void spin_project(const MatrixArray<3, 1, Real>& psi,
+                             MatrixArray<3, 1, Real>& out)
+    {
+      static_assert(Mu < 4, "spin_project: Mu must be < 4");
+      static_assert(Sign == 1 or Sign == -1,
+                    "spin_project: Sign must be +/-1");
+      for (unsigned int alpha = 0; alpha < num_spins; ++alpha) {
+        out[alpha] = psi[alpha]
+          + (Real(Sign) * coefficient<Real>(Mu, alpha))
+          * psi[column[Mu][alpha]];
+      }
+    }
+  }
+}
+
+#endif
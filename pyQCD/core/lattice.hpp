@@ -16,31 +16,37 @@
 
 namespace pyQCD
 {
-  template <typename T, template <typename> class Alloc = std::allocator>
-  class Lattice : public Array<T, Alloc, Lattice<T, Alloc> >
+  template <typename T, template <typename> class Alloc = std::allocator,
+    typename L = Layout>
+  class Lattice : public Array<T, Alloc, Lattice<T, Alloc, L> >
   {
   public:
     Lattice() : layout_(nullptr) { }
-    Lattice(const Layout& layout)
-      : Array<T, Alloc, Lattice<T, Alloc> >(), layout_(&layout)
+    Lattice(const L& layout)
+      : Array<T, Alloc, Lattice<T, Alloc, L> >(), layout_(&layout)
     {
       this->data_.resize(layout.volume());
     }
-    Lattice(const Layout& layout, const T& val)
-      : Array<T, Alloc, Lattice<T, Alloc> >(layout.volume(), val),
+    Lattice(const L& layout, const T& val)
+      : Array<T, Alloc, Lattice<T, Alloc, L> >(layout.volume(), val),
         layout_(&layout)
     {}
-    Lattice(const Lattice<T, Alloc>& lattice) = default;
+    Lattice(const Lattice<T, Alloc, L>& lattice) = default;
     template <typename U1, typename U2>
     Lattice(const ArrayExpr<U1, U2>& expr)
     {
       this->data_.resize(expr.size());
-      for (unsigned long i = 0; i < expr.size(); ++i) {
-        this->data_[i] = static_cast<T>(expr[i]);
-      }
-      layout_ = expr.layout();
+      T* ptr = &(this->data_)[0];
+      const unsigned long size = expr.size();
+      PYQCD_SCOPED_KERNEL("Lattice(expr)", 2 * size * sizeof(T), 0);
+      parallel_for(size, [ptr, &expr] (const unsigned long i)
+        { ptr[i] = static_cast<T>(expr[i]); });
+      // Expressions carry their layout as a plain Layout pointer; the
+      // operands of any expression assigned to this lattice were built over
+      // an L, so the downcast merely restores the static type
+      layout_ = static_cast<const L*>(expr.layout());
     }
-    Lattice(Lattice<T, Alloc>&& lattice) = default;
+    Lattice(Lattice<T, Alloc, L>&& lattice) = default;
 
     T& operator()(const int i)
     { return this->data_[layout_->get_array_index(i)]; }
@@ -53,33 +59,75 @@ namespace pyQCD
     const T& operator()(const U& site) const
     { return this->data_[layout_->get_array_index(site)]; }
 
-    Lattice<T, Alloc>& operator=(const Lattice<T, Alloc>& lattice);
-    Lattice<T, Alloc>& operator=(Lattice<T, Alloc>&& lattice) = default;
+    Lattice<T, Alloc, L>& operator=(const Lattice<T, Alloc, L>& lattice);
+    Lattice<T, Alloc, L>& operator=(Lattice<T, Alloc, L>&& lattice) = default;
     template <typename U1, typename U2>
-    Lattice<T, Alloc>& operator=(const ArrayExpr<U1, U2>& expr)
+    Lattice<T, Alloc, L>& operator=(const ArrayExpr<U1, U2>& expr)
     {
       pyQCDassert ((this->data_.size() == expr.size()),
                    std::out_of_range("Array::data_"));
       T* ptr = &(this->data_)[0];
-      for (unsigned long i = 0; i < expr.size(); ++i) {
-        ptr[i] = static_cast<T>(expr[i]);
-      }
-      layout_ = expr.layout();
+      const unsigned long size = expr.size();
+      PYQCD_SCOPED_KERNEL("Lattice::operator=(expr)",
+                          2 * size * sizeof(T), 0);
+      parallel_for(size, [ptr, &expr] (const unsigned long i)
+        { ptr[i] = static_cast<T>(expr[i]); });
+      // Expressions carry their layout as a plain Layout pointer; the
+      // operands of any expression assigned to this lattice were built over
+      // an L, so the downcast merely restores the static type
+      layout_ = static_cast<const L*>(expr.layout());
       return *this;
     }
 
+    // Pull the value at each site's neighbour, one unit along dimension dim
+    // (direction 0 for the positive shift, 1 for the negative one), into a new
+    // lattice: result(x) = (*this)(x + shift). The walk is driven entirely by
+    // the Layout's precomputed neighbour table.
+    Lattice<T, Alloc, L> gather(const unsigned int dim,
+                             const unsigned int direction) const
+    {
+      Lattice<T, Alloc, L> result(*layout_);
+      for (unsigned int i = 0; i < volume(); ++i) {
+        result[i] = this->data_[layout_->get_neighbour_index(i, dim,
+                                                             direction)];
+      }
+      return result;
+    }
+
+    // Accessors for a single parity half of the lattice. These assume the
+    // associated Layout stores the even sublattice contiguously before the odd
+    // sublattice (as EvenOddLayout does).
+    typename std::vector<T, Alloc<T> >::iterator
+    parity_begin(const unsigned int parity)
+    { return this->data_.begin() + parity * (volume() / 2); }
+    typename std::vector<T, Alloc<T> >::const_iterator
+    parity_begin(const unsigned int parity) const
+    { return this->data_.begin() + parity * (volume() / 2); }
+    typename std::vector<T, Alloc<T> >::iterator
+    parity_end(const unsigned int parity)
+    { return this->data_.begin() + (parity + 1) * (volume() / 2); }
+    typename std::vector<T, Alloc<T> >::const_iterator
+    parity_end(const unsigned int parity) const
+    { return this->data_.begin() + (parity + 1) * (volume() / 2); }
+
+    void swap(Lattice<T, Alloc, L>& other)
+    {
+      this->data_.swap(other.data_);
+      std::swap(layout_, other.layout_);
+    }
+
     unsigned int volume() const { return layout_->volume(); }
     unsigned int num_dims() const { return layout_->num_dims(); }
-    const Layout* layout() const { return layout_; }
+    const L* layout() const { return layout_; }
 
   protected:
-    const Layout* layout_;
+    const L* layout_;
   };
 
 
-  template <typename T, template <typename> class Alloc>
-  Lattice<T, Alloc>& Lattice<T, Alloc>::operator=(
-    const Lattice<T, Alloc>& lattice)
+  template <typename T, template <typename> class Alloc, typename L>
+  Lattice<T, Alloc, L>& Lattice<T, Alloc, L>::operator=(
+    const Lattice<T, Alloc, L>& lattice)
   {
     if (layout_) {
       pyQCDassert (lattice.volume() == volume(),
@@ -89,12 +137,55 @@ namespace pyQCD
       layout_ = lattice.layout_;
     }
     if (&lattice != this) {
-      for (unsigned int i = 0; i < volume(); ++i) {
-        (*this)(lattice.layout_->get_site_index(i)) = lattice[i];
+      if (layout_ == lattice.layout_) {
+        // Same layout object: the site orderings agree, so a straight
+        // contiguous copy is valid and the per-site index translation below
+        // is pure overhead
+        this->data_ = lattice.data_;
+      }
+      else {
+        for (unsigned int i = 0; i < volume(); ++i) {
+          (*this)(lattice.layout_->get_site_index(i)) = lattice[i];
+        }
       }
     }
     return *this;
   }
+
+
+  template <typename T, template <typename> class Alloc, typename L>
+  void swap(Lattice<T, Alloc, L>& lhs, Lattice<T, Alloc, L>& rhs)
+  { lhs.swap(rhs); }
+
+
+  // Rvalue counterparts of the expression-template operators: an expiring
+  // Lattice operand donates its buffer to the result instead of a fresh
+  // allocation being made for it.
+#define LATTICE_MOVE_OPERATOR(op)                                           \
+  template <typename T, template <typename> class Alloc, typename L>       \
+  Lattice<T, Alloc, L> operator op(Lattice<T, Alloc, L>&& lhs,             \
+                                   const Lattice<T, Alloc, L>& rhs)        \
+  {                                                                         \
+    lhs op ## = rhs;                                                        \
+    return std::move(lhs);                                                  \
+  }                                                                         \
+                                                                            \
+                                                                            \
+  template <typename T, template <typename> class Alloc, typename L,       \
+    typename U,                                                             \
+    typename std::enable_if<                                                \
+      not std::is_base_of<ArrayObj, U>::value>::type* = nullptr>            \
+  Lattice<T, Alloc, L> operator op(Lattice<T, Alloc, L>&& lhs,             \
+                                   const U& rhs)                            \
+  {                                                                         \
+    lhs op ## = rhs;                                                        \
+    return std::move(lhs);                                                  \
+  }
+
+  LATTICE_MOVE_OPERATOR(+);
+  LATTICE_MOVE_OPERATOR(-);
+  LATTICE_MOVE_OPERATOR(*);
+  LATTICE_MOVE_OPERATOR(/);
 }
 
 #endif
@@ -0,0 +1,71 @@
+#ifndef LATTICE_CAST_HPP
+#define LATTICE_CAST_HPP
+
+/* This file provides cheap precision conversion between lattices of the
+ * float and double type families (see the generated types.hpp), as needed by
+ * mixed-precision algorithms that iterate in single precision and correct in
+ * double. Site values are converted element-wise in one parallel pass; the
+ * Layout is shared with the source lattice.
+ */
+
+#include <complex>
+
+#include <Eigen/Dense>
+
+#include <utils/macros.hpp>
+#include <utils/thread_pool.hpp>
+
+#include "lattice.hpp"
+#include "matrix_array.hpp"
+
+
+namespace pyQCD
+{
+  namespace detail
+  {
+    // Site-level conversion: plain scalars convert directly, Eigen matrices
+    // through cast<>, MatrixArray element-wise
+    template <typename T, typename U>
+    struct SiteCast
+    {
+      static T apply(const U& value) { return static_cast<T>(value); }
+    };
+
+    template <typename S, int N, int M, typename U>
+    struct SiteCast<Eigen::Matrix<S, N, M>, U>
+    {
+      static Eigen::Matrix<S, N, M> apply(const U& value)
+      { return value.template cast<S>(); }
+    };
+
+    template <int N, int M, typename T, typename U>
+    struct SiteCast<MatrixArray<N, M, T>, MatrixArray<N, M, U> >
+    {
+      static MatrixArray<N, M, T> apply(const MatrixArray<N, M, U>& value)
+      {
+        MatrixArray<N, M, T> ret(
+          static_cast<int>(value.size()),
+          Eigen::Matrix<std::complex<T>, N, M>::Zero());
+        for (unsigned long i = 0; i < value.size(); ++i) {
+          ret[i] = value[i].template cast<std::complex<T> >();
+        }
+        return ret;
+      }
+    };
+  }
+
+
+  // Convert a lattice to the site type T, e.g.
+  //   lattice_cast<ColourMatrixF, Eigen::aligned_allocator>(gauge_field)
+  template <typename T, template <typename> class Alloc = std::allocator,
+    typename U, template <typename> class AllocU, typename L>
+  Lattice<T, Alloc, L> lattice_cast(const Lattice<U, AllocU, L>& lattice)
+  {
+    Lattice<T, Alloc, L> ret(*lattice.layout());
+    parallel_for(lattice.volume(), [&ret, &lattice] (const unsigned long i)
+      { ret[i] = detail::SiteCast<T, U>::apply(lattice[i]); });
+    return ret;
+  }
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef LATTICE_VIEW_HPP
+#define LATTICE_VIEW_HPP
+
+/* This file provides lightweight non-owning views over subsets of a
+ * Lattice's sites - a timeslice and a general rectangular sublattice. A view
+ * holds the array indices of its sites and references the parent lattice's
+ * storage directly, so it participates in the expression templates and the
+ * reductions of detail/reductions.hpp without copying any site data; it is
+ * also assignable, so e.g. a source timeslice can be written in place.
+ *
+ * Views carry no Layout, so an expression rooted in a view should be reduced
+ * (sum, norm2, dot) or assigned into another view or a plain Array - not into
+ * a Lattice, which takes its layout from the expression it is built from.
+ */
+
+#include <vector>
+
+#include <utils/macros.hpp>
+
+#include "lattice.hpp"
+#include "layout.hpp"
+
+
+namespace pyQCD
+{
+  template <typename T, template <typename> class Alloc = std::allocator>
+  class LatticeView : public ArrayExpr<LatticeView<T, Alloc>, T>
+  {
+  public:
+    LatticeView(Lattice<T, Alloc>& lattice,
+                std::vector<unsigned int> array_indices)
+      : lattice_(&lattice), array_indices_(std::move(array_indices))
+    { }
+
+    T& operator[](const unsigned long i)
+    { return (*lattice_)[array_indices_[i]]; }
+    const T& operator[](const unsigned long i) const
+    { return (*lattice_)[array_indices_[i]]; }
+
+    // Views carry no layout of their own: site ordering is defined by the
+    // index list, and expressions mixing views are checked on size only
+    const Layout* layout() const { return nullptr; }
+    unsigned long size() const { return array_indices_.size(); }
+
+    LatticeView& operator=(const T& rhs)
+    {
+      for (unsigned long i = 0; i < size(); ++i) {
+        (*this)[i] = rhs;
+      }
+      return *this;
+    }
+
+    template <typename U1, typename U2>
+    LatticeView& operator=(const ArrayExpr<U1, U2>& expr)
+    {
+      pyQCDassert ((size() == expr.size()),
+                   std::out_of_range("LatticeView::size()"));
+      for (unsigned long i = 0; i < size(); ++i) {
+        (*this)[i] = static_cast<T>(expr[i]);
+      }
+      return *this;
+    }
+
+  private:
+    Lattice<T, Alloc>* lattice_;
+    std::vector<unsigned int> array_indices_;
+  };
+
+
+  // View of all sites with the given coordinate along dim (for dim 0, a
+  // timeslice), in lexicographic order of the remaining coordinates
+  template <typename T, template <typename> class Alloc>
+  LatticeView<T, Alloc> timeslice(Lattice<T, Alloc>& lattice,
+                                  const unsigned int time,
+                                  const unsigned int dim = 0)
+  {
+    const Layout& layout = *lattice.layout();
+    const std::vector<unsigned int>& shape = layout.shape();
+    pyQCDassert ((time < shape[dim]),
+      std::out_of_range("timeslice: time >= shape[dim]"));
+    std::vector<unsigned int> indices;
+    indices.reserve(layout.volume() / shape[dim]);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      unsigned int remainder = i;
+      bool in_slice = true;
+      for (unsigned int d = layout.num_dims(); d-- > 0;) {
+        if (d == dim and remainder % shape[d] != time) {
+          in_slice = false;
+          break;
+        }
+        remainder /= shape[d];
+      }
+      if (in_slice) {
+        indices.push_back(layout.get_array_index(i));
+      }
+    }
+    return LatticeView<T, Alloc>(lattice, std::move(indices));
+  }
+
+
+  // View of the rectangular block [corner, corner + shape) with periodic
+  // wrapping, sites in lexicographic order of the local coordinates
+  template <typename T, template <typename> class Alloc>
+  LatticeView<T, Alloc> sublattice(Lattice<T, Alloc>& lattice,
+                                   const std::vector<unsigned int>& corner,
+                                   const std::vector<unsigned int>& shape)
+  {
+    const Layout& layout = *lattice.layout();
+    const unsigned int ndims = layout.num_dims();
+    pyQCDassert ((corner.size() == ndims and shape.size() == ndims),
+      std::invalid_argument("sublattice: corner/shape dimension mismatch"));
+    unsigned int block_volume = 1;
+    for (unsigned int d = 0; d < ndims; ++d) {
+      block_volume *= shape[d];
+    }
+    std::vector<unsigned int> indices(block_volume);
+    std::vector<unsigned int> site(ndims);
+    for (unsigned int i = 0; i < block_volume; ++i) {
+      unsigned int remainder = i;
+      for (unsigned int d = ndims; d-- > 0;) {
+        site[d] = (corner[d] + remainder % shape[d]) % layout.shape()[d];
+        remainder /= shape[d];
+      }
+      indices[i] = layout.get_array_index(site);
+    }
+    return LatticeView<T, Alloc>(lattice, std::move(indices));
+  }
+}
+
+#endif
@@ -8,9 +8,13 @@
 
 #include <functional>
 #include <numeric>
+#include <stdexcept>
 #include <type_traits>
 #include <vector>
 
+#include <utils/macros.hpp>
+#include <utils/math.hpp>
+
 
 namespace pyQCD
 {
@@ -39,6 +43,8 @@ namespace pyQCD
         array_indices_[site_index] = array_index;
         site_indices_[array_index] = site_index;
       }
+
+      initialise_neighbour_indices();
     }
     virtual ~Layout() = default;
 
@@ -50,19 +56,91 @@ namespace pyQCD
     inline unsigned int get_site_index(const unsigned int array_index) const
     { return site_indices_[array_index]; }
 
+    // Look up the array index of the neighbour of the site held at
+    // array_index, one unit along dimension dim (direction 0 is the positive
+    // shift, direction 1 the negative one, with periodic wrapping). The table
+    // is precomputed at construction, so a stencil sweep pays a single table
+    // load per neighbour rather than recomputing the lexicographic index.
+    inline unsigned int get_neighbour_index(
+      const unsigned int array_index, const unsigned int dim,
+      const unsigned int direction) const
+    { return neighbour_indices_[(array_index * num_dims_ + dim) * 2
+                                + direction]; }
+
     unsigned int volume() const { return lattice_volume_; }
     unsigned int num_dims() const { return num_dims_; }
+    const std::vector<unsigned int>& shape() const { return lattice_shape_; }
+
+  protected:
+    // Tag-dispatched constructor for layouts whose site-to-array mapping is
+    // the identity and is computed inline by the derived type: the
+    // indirection vectors are never allocated (the neighbour table still is).
+    // Such layouts must shadow get_array_index/get_site_index, and only the
+    // shadowed accessors - i.e. access through the derived type - are valid.
+    struct IdentityMappingTag { };
+    Layout(const std::vector<unsigned int>& lattice_shape, IdentityMappingTag)
+      : num_dims_(static_cast<unsigned int>(lattice_shape.size())),
+        lattice_shape_(lattice_shape)
+    {
+      lattice_volume_ = std::accumulate(lattice_shape.begin(),
+                                        lattice_shape.end(),
+                                        unsigned(1),
+                                        std::multiplies<unsigned int>());
+      initialise_neighbour_indices();
+    }
 
   private:
+    void initialise_neighbour_indices();
+
     unsigned int num_dims_, lattice_volume_;
     std::vector<unsigned int> lattice_shape_;
     // array_indices_[site_index] -> array_index
     std::vector<unsigned int> array_indices_;
     // site_indices_[array_index] -> site_index
     std::vector<unsigned int> site_indices_;
+    // neighbour_indices_[(array_index * num_dims_ + dim) * 2 + direction]
+    //   -> array index of the +/- unit shift neighbour
+    std::vector<unsigned int> neighbour_indices_;
   };
 
 
+  inline void Layout::initialise_neighbour_indices()
+  {
+    neighbour_indices_.resize(2 * num_dims_ * lattice_volume_);
+    std::vector<unsigned int> site(num_dims_);
+    for (unsigned int site_index = 0;
+         site_index < lattice_volume_;
+         ++site_index) {
+      // Unpack the lexicographic index into site coordinates
+      unsigned int remainder = site_index;
+      for (unsigned int d = num_dims_; d-- > 0;) {
+        site[d] = remainder % lattice_shape_[d];
+        remainder /= lattice_shape_[d];
+      }
+      // An empty indirection vector denotes the identity mapping (see the
+      // IdentityMappingTag constructor)
+      unsigned int array_index
+        = array_indices_.empty() ? site_index : array_indices_[site_index];
+      for (unsigned int d = 0; d < num_dims_; ++d) {
+        for (unsigned int direction = 0; direction < 2; ++direction) {
+          int shift = (direction == 0) ? 1 : -1;
+          unsigned int neighbour_coord
+            = mod(static_cast<int>(site[d]) + shift, lattice_shape_[d]);
+          // Lexicographic index of the shifted site
+          unsigned int neighbour_site_index = 0;
+          for (unsigned int j = 0; j < num_dims_; ++j) {
+            neighbour_site_index *= lattice_shape_[j];
+            neighbour_site_index += (j == d) ? neighbour_coord : site[j];
+          }
+          neighbour_indices_[(array_index * num_dims_ + d) * 2 + direction]
+            = array_indices_.empty() ? neighbour_site_index
+                                     : array_indices_[neighbour_site_index];
+        }
+      }
+    }
+  }
+
+
   class LexicoLayout : public Layout
   {
   public:
@@ -73,6 +151,232 @@ namespace pyQCD
   };
 
 
+  class StaticLexicoLayout : public Layout
+  {
+    // Lexicographic layout with the site-to-array mapping resolved at compile
+    // time: accesses through this type (e.g. via the layout parameter of
+    // Lattice) inline to the identity or a stride computation, and the
+    // per-site indirection vectors of the dynamic layouts are not allocated.
+    // The shadowed accessors below are only reached through the static type,
+    // so this layout must not be used for index lookups through a plain
+    // Layout pointer.
+  public:
+    StaticLexicoLayout() { }
+    StaticLexicoLayout(const std::vector<unsigned int>& shape)
+      : Layout(shape, IdentityMappingTag())
+    { }
+
+    inline unsigned int get_array_index(const unsigned int site_index) const
+    { return site_index; }
+    inline unsigned int get_site_index(const unsigned int array_index) const
+    { return array_index; }
+    template <typename T,
+      typename std::enable_if<not std::is_integral<T>::value>::type* = nullptr>
+    inline unsigned int get_array_index(const T& site) const
+    {
+      unsigned int site_index = 0;
+      for (unsigned int i = 0; i < num_dims(); ++i) {
+        site_index *= shape()[i];
+        site_index += site[i];
+      }
+      return site_index;
+    }
+  };
+
+
+  namespace detail
+  {
+    // Compile-time volume of a constexpr shape pack
+    template <unsigned int... Shape>
+    struct ShapeProduct;
+
+    template <>
+    struct ShapeProduct<>
+    {
+      static constexpr unsigned int value = 1;
+    };
+
+    template <unsigned int Head, unsigned int... Tail>
+    struct ShapeProduct<Head, Tail...>
+    {
+      static constexpr unsigned int value
+        = Head * ShapeProduct<Tail...>::value;
+    };
+
+    // Fully unrolled lexicographic index of a site against a constexpr
+    // shape: the recursion flattens to a chain of multiply-adds with the
+    // strides folded in as literals
+    template <unsigned int... Shape>
+    struct LexicoIndex;
+
+    template <>
+    struct LexicoIndex<>
+    {
+      template <typename T>
+      static unsigned int compute(const T&, const unsigned int,
+                                  const unsigned int acc)
+      { return acc; }
+    };
+
+    template <unsigned int Head, unsigned int... Tail>
+    struct LexicoIndex<Head, Tail...>
+    {
+      template <typename T>
+      static unsigned int compute(const T& site, const unsigned int dim,
+                                  const unsigned int acc)
+      {
+        return LexicoIndex<Tail...>::compute(site, dim + 1,
+                                             acc * Head + site[dim]);
+      }
+    };
+  }
+
+
+  template <unsigned int Nd>
+  class FixedLexicoLayout : public Layout
+  {
+    // Lexicographic layout with the dimension count fixed at compile time:
+    // the coordinate-indexing loop runs over a constant trip count against a
+    // fixed-size stride array, so the compiler unrolls it completely instead
+    // of iterating a runtime num_dims() over a std::vector. Like
+    // StaticLexicoLayout, accesses are only valid through the static type.
+  public:
+    FixedLexicoLayout(const std::vector<unsigned int>& shape)
+      : Layout(shape, IdentityMappingTag())
+    {
+      pyQCDassert ((shape.size() == Nd),
+        std::invalid_argument("FixedLexicoLayout: shape.size() != Nd"));
+      for (unsigned int d = 0; d < Nd; ++d) {
+        shape_[d] = shape[d];
+      }
+    }
+
+    inline unsigned int get_array_index(const unsigned int site_index) const
+    { return site_index; }
+    inline unsigned int get_site_index(const unsigned int array_index) const
+    { return array_index; }
+    template <typename T,
+      typename std::enable_if<not std::is_integral<T>::value>::type* = nullptr>
+    inline unsigned int get_array_index(const T& site) const
+    {
+      unsigned int site_index = 0;
+      for (unsigned int i = 0; i < Nd; ++i) {
+        site_index *= shape_[i];
+        site_index += site[i];
+      }
+      return site_index;
+    }
+
+  private:
+    unsigned int shape_[Nd];
+  };
+
+
+  template <unsigned int... Shape>
+  class ConstShapeLexicoLayout : public FixedLexicoLayout<sizeof...(Shape)>
+  {
+    // Lexicographic layout for a lattice shape fixed at compile time, for
+    // the production volumes baked in by the code generator: the strides are
+    // constexpr, so a coordinate access folds to a handful of multiply-adds
+    // with literal operands.
+  public:
+    ConstShapeLexicoLayout()
+      : FixedLexicoLayout<sizeof...(Shape)>(
+          std::vector<unsigned int>{Shape...})
+    { }
+
+    static constexpr unsigned int static_volume
+      = detail::ShapeProduct<Shape...>::value;
+
+    inline unsigned int get_array_index(const unsigned int site_index) const
+    { return site_index; }
+    inline unsigned int get_site_index(const unsigned int array_index) const
+    { return array_index; }
+    template <typename T,
+      typename std::enable_if<not std::is_integral<T>::value>::type* = nullptr>
+    inline unsigned int get_array_index(const T& site) const
+    { return detail::LexicoIndex<Shape...>::compute(site, 0, 0); }
+  };
+
+
+  class EvenOddLayout : public Layout
+  {
+    // Here we order the sites so that the even sublattice (sites where the
+    // coordinate sum is even) occupies the first half of the array and the odd
+    // sublattice the second half, with each half in lexicographic order. This
+    // keeps the working set of a red-black sweep contiguous.
+  public:
+    EvenOddLayout() { }
+    EvenOddLayout(const std::vector<unsigned int>& shape)
+      : Layout(shape, [shape] (const unsigned int i)
+    {
+      unsigned int volume = std::accumulate(shape.begin(), shape.end(), 1u,
+        std::multiplies<unsigned int>());
+      pyQCDassert ((shape.back() % 2 == 0),
+        std::invalid_argument("EvenOddLayout: shape.back() % 2 != 0"));
+      // Compute the parity of the site from its coordinate sum
+      unsigned int parity = 0;
+      unsigned int remainder = i;
+      for (unsigned int j = shape.size(); j-- > 0;) {
+        parity += remainder % shape[j];
+        remainder /= shape[j];
+      }
+      // Within each parity the sites retain their lexicographic order. As the
+      // last coordinate flips the parity with each increment (shape.back() is
+      // even), site i is preceded by (i - i % shape.back()) / 2
+      // + (i % shape.back()) / 2 sites of the same parity.
+      unsigned int j = i % shape.back();
+      return (parity % 2) * (volume / 2) + (i - j) / 2 + j / 2;
+    })
+    { }
+  };
+
+
+  class TiledLayout : public Layout
+  {
+    // Here the lattice is partitioned into rectangular tiles and the sites of
+    // each tile are stored contiguously, tiles and sites within each tile both
+    // in lexicographic order. A stencil sweep then revisits a tile's sites
+    // while they are still cached, rather than striding megabytes between the
+    // neighbours in the slow dimensions, so the tile shape should be chosen so
+    // a tile (and its surface) fits in L2.
+  public:
+    TiledLayout() { }
+    TiledLayout(const std::vector<unsigned int>& shape,
+                const std::vector<unsigned int>& tile_shape)
+      : Layout(shape, [shape, tile_shape] (const unsigned int i)
+    {
+      pyQCDassert ((tile_shape.size() == shape.size()),
+        std::invalid_argument("TiledLayout: tile_shape.size() != shape.size()"));
+      unsigned int num_tiles = 1, tile_volume = 1;
+      for (unsigned int d = 0; d < shape.size(); ++d) {
+        pyQCDassert ((tile_shape[d] > 0 and shape[d] % tile_shape[d] == 0),
+          std::invalid_argument("TiledLayout: shape % tile_shape != 0"));
+        num_tiles *= shape[d] / tile_shape[d];
+        tile_volume *= tile_shape[d];
+      }
+      (void) num_tiles;
+      // Split each coordinate into a tile coordinate and an offset within
+      // the tile, then index tiles and intra-tile offsets lexicographically
+      unsigned int tile_index = 0, tile_offset = 0;
+      unsigned int remainder = i;
+      std::vector<unsigned int> site(shape.size());
+      for (unsigned int d = shape.size(); d-- > 0;) {
+        site[d] = remainder % shape[d];
+        remainder /= shape[d];
+      }
+      for (unsigned int d = 0; d < shape.size(); ++d) {
+        tile_index *= shape[d] / tile_shape[d];
+        tile_index += site[d] / tile_shape[d];
+        tile_offset *= tile_shape[d];
+        tile_offset += site[d] % tile_shape[d];
+      }
+      return tile_index * tile_volume + tile_offset;
+    })
+    { }
+  };
+
+
   template <typename T,
     typename std::enable_if<not std::is_integral<T>::value>::type*>
   inline unsigned int Layout::get_array_index(const T& site) const
@@ -0,0 +1,138 @@
+#ifndef SMEARING_HPP
+#define SMEARING_HPP
+
+/* This file provides APE and stout gauge-link smearing over per-dimension
+ * Lattices of SU(3) links. Each smearing level fuses staple accumulation,
+ * projection/exponentiation and the link update into one parallel pass per
+ * dimension, writing into a single scratch buffer that is swapped with the
+ * input field afterwards — so exactly two link-field buffers exist however
+ * many levels are applied, instead of one full field sweep per
+ * expression-template operation.
+ */
+
+#include <complex>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/MatrixFunctions>
+
+#include <core/lattice.hpp>
+#include <core/layout.hpp>
+#include <utils/macros.hpp>
+#include <utils/thread_pool.hpp>
+
+
+namespace pyQCD
+{
+  namespace detail
+  {
+    // Sum of staples attached to the link (site i, direction mu):
+    //   C_mu(x) = sum_{nu != mu} [ U_nu(x) U_mu(x + nu) U_nu(x + mu)^dag
+    //     + U_nu(x - nu)^dag U_mu(x - nu) U_nu(x - nu + mu) ],
+    // a sum of paths from x to x + mu sharing the link's orientation
+    template <typename Real, template <typename> class Alloc>
+    Eigen::Matrix<std::complex<Real>, 3, 3> staple_sum(
+      const std::vector<Lattice<Eigen::Matrix<std::complex<Real>, 3, 3>,
+                                Alloc> >& gauge_field,
+      const Layout& layout, const unsigned int i, const unsigned int mu)
+    {
+      Eigen::Matrix<std::complex<Real>, 3, 3> ret
+        = Eigen::Matrix<std::complex<Real>, 3, 3>::Zero();
+      const unsigned int fwd_mu = layout.get_neighbour_index(i, mu, 0);
+      for (unsigned int nu = 0; nu < layout.num_dims(); ++nu) {
+        if (nu == mu) {
+          continue;
+        }
+        const unsigned int fwd_nu = layout.get_neighbour_index(i, nu, 0);
+        const unsigned int bwd_nu = layout.get_neighbour_index(i, nu, 1);
+        const unsigned int bwd_nu_fwd_mu
+          = layout.get_neighbour_index(bwd_nu, mu, 0);
+        ret += gauge_field[nu][i] * gauge_field[mu][fwd_nu]
+          * gauge_field[nu][fwd_mu].adjoint();
+        ret += gauge_field[nu][bwd_nu].adjoint() * gauge_field[mu][bwd_nu]
+          * gauge_field[nu][bwd_nu_fwd_mu];
+      }
+      return ret;
+    }
+  }
+
+
+  // Project a matrix back onto SU(3): W (W^dag W)^{-1/2}, with the residual
+  // U(1) phase divided out
+  template <typename Real>
+  Eigen::Matrix<std::complex<Real>, 3, 3> project_su3(
+    const Eigen::Matrix<std::complex<Real>, 3, 3>& mat)
+  {
+    typedef Eigen::Matrix<std::complex<Real>, 3, 3> ColourMatrix;
+    Eigen::SelfAdjointEigenSolver<ColourMatrix> solver(mat.adjoint() * mat);
+    ColourMatrix inverse_sqrt = solver.eigenvectors()
+      * solver.eigenvalues().cwiseSqrt().cwiseInverse().asDiagonal()
+      * solver.eigenvectors().adjoint();
+    ColourMatrix ret = mat * inverse_sqrt;
+    return ret / std::pow(ret.determinant(), 1.0 / 3.0);
+  }
+
+
+  // APE smearing: each level replaces every link with the SU(3) projection
+  // of (1 - alpha) U_mu(x) + alpha / (2 (Nd - 1)) C_mu(x)
+  template <typename Real, template <typename> class Alloc>
+  void ape_smear(
+    std::vector<Lattice<Eigen::Matrix<std::complex<Real>, 3, 3>,
+                        Alloc> >& gauge_field,
+    const unsigned int num_levels, const Real alpha)
+  {
+    const Layout& layout = *gauge_field[0].layout();
+    const unsigned int volume = layout.volume();
+    const Real staple_weight = alpha / (2 * (layout.num_dims() - 1));
+    std::vector<Lattice<Eigen::Matrix<std::complex<Real>, 3, 3>, Alloc> >
+      buffer = gauge_field;
+    for (unsigned int level = 0; level < num_levels; ++level) {
+      for (unsigned int mu = 0; mu < layout.num_dims(); ++mu) {
+        parallel_for(volume,
+          [&buffer, &gauge_field, &layout, alpha, staple_weight, mu]
+          (const unsigned long i) {
+            buffer[mu][i] = project_su3<Real>(
+              (1 - alpha) * gauge_field[mu][i]
+              + staple_weight
+                * detail::staple_sum(gauge_field, layout, i, mu));
+          });
+      }
+      std::swap(gauge_field, buffer);
+    }
+  }
+
+
+  // Stout smearing (Peardon-Morningstar): U' = exp(i Q_mu(x)) U_mu(x) with
+  // Q_mu(x) the traceless hermitian part of i Omega, Omega = rho C_mu U^dag
+  template <typename Real, template <typename> class Alloc>
+  void stout_smear(
+    std::vector<Lattice<Eigen::Matrix<std::complex<Real>, 3, 3>,
+                        Alloc> >& gauge_field,
+    const unsigned int num_levels, const Real rho)
+  {
+    typedef Eigen::Matrix<std::complex<Real>, 3, 3> ColourMatrix;
+    typedef std::complex<Real> Complex;
+    const Layout& layout = *gauge_field[0].layout();
+    const unsigned int volume = layout.volume();
+    std::vector<Lattice<ColourMatrix, Alloc> > buffer = gauge_field;
+    for (unsigned int level = 0; level < num_levels; ++level) {
+      for (unsigned int mu = 0; mu < layout.num_dims(); ++mu) {
+        parallel_for(volume,
+          [&buffer, &gauge_field, &layout, rho, mu] (const unsigned long i) {
+            const ColourMatrix omega
+              = rho * detail::staple_sum(gauge_field, layout, i, mu)
+              * gauge_field[mu][i].adjoint();
+            const ColourMatrix omega_diff = omega.adjoint() - omega;
+            const ColourMatrix q_mu = Complex(0.0, 0.5)
+              * (omega_diff
+                 - omega_diff.trace() / Real(3.0) * ColourMatrix::Identity());
+            buffer[mu][i]
+              = (Complex(0.0, 1.0) * q_mu).exp() * gauge_field[mu][i];
+          });
+      }
+      std::swap(gauge_field, buffer);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef WILSON_LOOPS_HPP
+#define WILSON_LOOPS_HPP
+
+/* This file provides a measurement engine for plaquettes and rectangular
+ * Wilson loops over per-dimension Lattices of SU(3) links. Rather than
+ * walking every loop link by link, the engine builds "line products" - the
+ * ordered product of n links along one dimension from every site - once per
+ * (dimension, length) and caches them, so an r x t loop costs three matrix
+ * multiplies per site and adjacent loops share their straight sub-paths. The
+ * walks are driven by the Layout neighbour table throughout.
+ */
+
+#include <complex>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <core/lattice.hpp>
+#include <core/layout.hpp>
+#include <utils/macros.hpp>
+#include <utils/thread_pool.hpp>
+
+
+namespace pyQCD
+{
+  template <typename Real = double>
+  class WilsonLoopEngine
+  {
+  public:
+    typedef std::complex<Real> Complex;
+    typedef Eigen::Matrix<Complex, 3, 3> ColourMatrix;
+    typedef Lattice<ColourMatrix, Eigen::aligned_allocator> GaugeField;
+
+    WilsonLoopEngine(const std::vector<GaugeField>& gauge_field)
+      : gauge_field_(&gauge_field), layout_(gauge_field[0].layout())
+    {
+      pyQCDassert ((gauge_field.size() == layout_->num_dims()),
+        std::invalid_argument("gauge_field.size() != num_dims()"));
+    }
+
+    // Per-site product around the r x t loop in the (mu, nu) plane:
+    //   W(x) = L_mu^r(x) L_nu^t(x + r mu) L_mu^r(x + t nu)^dag L_nu^t(x)^dag
+    GaugeField loop_field(const unsigned int r, const unsigned int mu,
+                          const unsigned int t, const unsigned int nu) const
+    {
+      const GaugeField& line_mu = line(mu, r);
+      const GaugeField& line_nu = line(nu, t);
+      GaugeField ret(*layout_);
+      parallel_for(layout_->volume(),
+        [this, &ret, &line_mu, &line_nu, r, mu, t, nu]
+        (const unsigned long i) {
+          const unsigned int corner_mu = advance(i, mu, r);
+          const unsigned int corner_nu = advance(i, nu, t);
+          ret[i] = line_mu[i] * line_nu[corner_mu]
+            * line_mu[corner_nu].adjoint() * line_nu[i].adjoint();
+        });
+      return ret;
+    }
+
+    // Mean of Re tr W / 3 over all sites of the given loop shape
+    Real average_loop(const unsigned int r, const unsigned int mu,
+                      const unsigned int t, const unsigned int nu) const
+    {
+      const GaugeField loops = loop_field(r, mu, t, nu);
+      Real total = 0.0;
+      for (unsigned int i = 0; i < loops.volume(); ++i) {
+        total += loops[i].trace().real();
+      }
+      return total / (3 * loops.volume());
+    }
+
+    // Mean plaquette over all sites and planes
+    Real average_plaquette() const
+    {
+      Real total = 0.0;
+      unsigned int num_planes = 0;
+      for (unsigned int mu = 0; mu < layout_->num_dims(); ++mu) {
+        for (unsigned int nu = mu + 1; nu < layout_->num_dims(); ++nu) {
+          total += average_loop(1, mu, 1, nu);
+          num_planes++;
+        }
+      }
+      return total / num_planes;
+    }
+
+    // Mean r x t Wilson loop with t steps along the time direction
+    // (dimension 0) and r along each spatial dimension in turn
+    Real average_wilson_loop(const unsigned int r, const unsigned int t) const
+    {
+      Real total = 0.0;
+      for (unsigned int mu = 1; mu < layout_->num_dims(); ++mu) {
+        total += average_loop(t, 0, r, mu);
+      }
+      return total / (layout_->num_dims() - 1);
+    }
+
+    // Drop the cached line products, e.g. after the gauge field changes
+    void clear_cache() { line_cache_.clear(); }
+
+  private:
+    unsigned int advance(unsigned int index, const unsigned int dim,
+                         const unsigned int num_steps) const
+    {
+      for (unsigned int step = 0; step < num_steps; ++step) {
+        index = layout_->get_neighbour_index(index, dim, 0);
+      }
+      return index;
+    }
+
+    // Cached ordered product of length links along dim from each site:
+    //   L_dim^length(x) = U_dim(x) U_dim(x + dim) ... U_dim(x + (n-1) dim)
+    const GaugeField& line(const unsigned int dim,
+                           const unsigned int length) const
+    {
+      const std::pair<unsigned int, unsigned int> key(dim, length);
+      auto it = line_cache_.find(key);
+      if (it != line_cache_.end()) {
+        return it->second;
+      }
+      const GaugeField& links = (*gauge_field_)[dim];
+      GaugeField result(*layout_, ColourMatrix::Identity());
+      parallel_for(layout_->volume(),
+        [this, &result, &links, dim, length] (const unsigned long i) {
+          unsigned int index = i;
+          for (unsigned int step = 0; step < length; ++step) {
+            result[i] = result[i] * links[index];
+            index = layout_->get_neighbour_index(index, dim, 0);
+          }
+        });
+      return line_cache_.emplace(key, std::move(result)).first->second;
+    }
+
+    const std::vector<GaugeField>* gauge_field_;
+    const Layout* layout_;
+    mutable std::map<std::pair<unsigned int, unsigned int>, GaugeField>
+      line_cache_;
+  };
+}
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+/* This file provides incremental checkpoint/restart for long-running
+ * generation jobs. A Checkpointer keeps one file per lattice, split into
+ * fixed-size blocks with a per-block hash table: on each save() only blocks
+ * whose contents changed since the last checkpoint are rewritten at their
+ * fixed offsets, the hash table and header are updated last and a single
+ * fsync batches the whole checkpoint, so saving every few trajectories costs
+ * I/O proportional to the links actually touched rather than the full field.
+ *
+ * RNG state rides along for free: the Philox generator in utils/random.hpp
+ * is counter-based, so persisting (seed, update_num) in the header restores
+ * the random stream exactly. The element payload is stored in array order,
+ * like the lattice files of lattice_file.hpp, so a restart must reconstruct
+ * a Layout identical to the writer's.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <core/lattice.hpp>
+#include <core/layout.hpp>
+#include <utils/macros.hpp>
+#include <utils/thread_pool.hpp>
+
+
+namespace pyQCD
+{
+  struct CheckpointHeader
+  {
+    char magic[8];                // "pyQCDckp"
+    std::uint32_t version;
+    std::uint32_t layout_tag;     // 0 = lexicographic, 1 = even-odd
+    std::uint32_t num_dims;
+    std::uint32_t element_size;
+    std::uint32_t shape[8];
+    std::uint32_t block_size;     // elements per block
+    std::uint32_t num_blocks;
+    std::uint64_t data_offset;    // byte offset of the element array
+    std::uint64_t seed;
+    std::uint64_t update_num;
+    std::uint64_t checkpoint_id;  // incremented on every completed save
+  };
+
+  namespace detail
+  {
+    const char checkpoint_magic[8] = {'p', 'y', 'Q', 'C', 'D', 'c', 'k', 'p'};
+    const std::uint32_t checkpoint_version = 1;
+
+    // FNV-1a, used for block change detection
+    inline std::uint64_t fnv1a_hash(const char* data, const std::size_t size)
+    {
+      std::uint64_t hash = 0xCBF29CE484222325ULL;
+      for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001B3ULL;
+      }
+      return hash;
+    }
+  }
+
+
+  template <typename T, template <typename> class Alloc = std::allocator>
+  class Checkpointer
+  {
+    // Incremental checkpoint writer for one Lattice. Construction against an
+    // existing checkpoint file reloads its block hash table, so a restarted
+    // job carries on writing deltas against the on-disk contents.
+  public:
+    Checkpointer(const std::string& filename, const Layout& layout,
+                 const unsigned int block_size = 1024,
+                 const std::uint32_t layout_tag = 0)
+      : layout_(&layout), fd_(-1)
+    {
+      pyQCDassert ((layout.num_dims() <= 8),
+        std::invalid_argument("Checkpointer supports at most 8 dimensions"));
+      const unsigned int volume = layout.volume();
+      const unsigned int num_blocks = (volume - 1) / block_size + 1;
+
+      std::memset(&header_, 0, sizeof(header_));
+      std::memcpy(header_.magic, detail::checkpoint_magic, 8);
+      header_.version = detail::checkpoint_version;
+      header_.layout_tag = layout_tag;
+      header_.num_dims = layout.num_dims();
+      header_.element_size = sizeof(T);
+      for (unsigned int d = 0; d < layout.num_dims(); ++d) {
+        header_.shape[d] = layout.shape()[d];
+      }
+      header_.block_size = block_size;
+      header_.num_blocks = num_blocks;
+      header_.data_offset
+        = sizeof(CheckpointHeader) + num_blocks * sizeof(std::uint64_t);
+
+      fd_ = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+      if (fd_ < 0) {
+        throw std::runtime_error("Checkpointer: cannot open " + filename);
+      }
+      // Resume against an existing checkpoint if its geometry matches;
+      // otherwise every block starts dirty and the first save is a full write
+      CheckpointHeader existing;
+      if (pread(fd_, &existing, sizeof(existing), 0) == sizeof(existing)
+          and std::memcmp(existing.magic, detail::checkpoint_magic, 8) == 0
+          and existing.element_size == sizeof(T)
+          and existing.block_size == block_size
+          and existing.num_blocks == num_blocks
+          and std::memcmp(existing.shape, header_.shape,
+                          sizeof(header_.shape)) == 0) {
+        header_.checkpoint_id = existing.checkpoint_id;
+        block_hashes_.resize(num_blocks);
+        pread(fd_, &block_hashes_[0],
+              num_blocks * sizeof(std::uint64_t), sizeof(CheckpointHeader));
+      }
+    }
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+    ~Checkpointer()
+    {
+      if (fd_ >= 0) {
+        close(fd_);
+      }
+    }
+
+    // Persist the lattice and RNG state; returns the number of blocks
+    // actually written. Dirty blocks go out first, then the hash table and
+    // the header with a bumped checkpoint_id, then one fsync for the lot.
+    unsigned int save(const Lattice<T, Alloc>& lattice,
+                      const std::uint64_t seed, const std::uint64_t update_num)
+    {
+      pyQCDassert ((lattice.volume() == layout_->volume()),
+        std::invalid_argument("lattice.volume() != volume()"));
+      const unsigned int num_blocks = header_.num_blocks;
+      const char* data = reinterpret_cast<const char*>(&lattice[0]);
+
+      std::vector<std::uint64_t> hashes(num_blocks);
+      parallel_for(num_blocks, [this, &hashes, data] (const unsigned long b)
+        { hashes[b] = detail::fnv1a_hash(data + b * block_bytes(),
+                                         block_bytes(b)); });
+
+      unsigned int num_written = 0;
+      for (unsigned int b = 0; b < num_blocks; ++b) {
+        if (block_hashes_.empty() or hashes[b] != block_hashes_[b]) {
+          write_all(data + b * block_bytes(), block_bytes(b),
+                    header_.data_offset + b * block_bytes());
+          num_written++;
+        }
+      }
+      block_hashes_ = std::move(hashes);
+
+      header_.seed = seed;
+      header_.update_num = update_num;
+      header_.checkpoint_id++;
+      write_all(reinterpret_cast<const char*>(&block_hashes_[0]),
+                num_blocks * sizeof(std::uint64_t), sizeof(CheckpointHeader));
+      write_all(reinterpret_cast<const char*>(&header_), sizeof(header_), 0);
+      fsync(fd_);
+      return num_written;
+    }
+
+    std::uint64_t checkpoint_id() const { return header_.checkpoint_id; }
+
+  private:
+    std::size_t block_bytes() const
+    { return std::size_t(header_.block_size) * sizeof(T); }
+    // The final block may be short
+    std::size_t block_bytes(const unsigned int b) const
+    {
+      const std::size_t total = std::size_t(layout_->volume()) * sizeof(T);
+      const std::size_t begin = b * block_bytes();
+      return (begin + block_bytes() < total) ? block_bytes() : total - begin;
+    }
+
+    void write_all(const char* data, const std::size_t size,
+                   const std::uint64_t offset) const
+    {
+      std::size_t written = 0;
+      while (written < size) {
+        const ssize_t ret = pwrite(fd_, data + written, size - written,
+                                   offset + written);
+        if (ret < 0) {
+          throw std::runtime_error("Checkpointer: pwrite failed");
+        }
+        written += ret;
+      }
+    }
+
+    const Layout* layout_;
+    int fd_;
+    CheckpointHeader header_;
+    std::vector<std::uint64_t> block_hashes_;
+  };
+
+
+  // Restore a checkpoint into a lattice whose Layout matches the writer's;
+  // seed and update_num receive the persisted RNG state. Returns the
+  // checkpoint_id of the snapshot read.
+  template <typename T, template <typename> class Alloc>
+  std::uint64_t restore_checkpoint(const std::string& filename,
+                                   Lattice<T, Alloc>& lattice,
+                                   std::uint64_t& seed,
+                                   std::uint64_t& update_num)
+  {
+    const Layout* layout = lattice.layout();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("restore_checkpoint: cannot open " + filename);
+    }
+    CheckpointHeader header;
+    if (pread(fd, &header, sizeof(header), 0) != sizeof(header)
+        or std::memcmp(header.magic, detail::checkpoint_magic, 8) != 0
+        or header.element_size != sizeof(T)
+        or header.num_dims != layout->num_dims()) {
+      close(fd);
+      throw std::runtime_error("restore_checkpoint: " + filename
+                               + " is not a checkpoint of this type");
+    }
+    for (unsigned int d = 0; d < layout->num_dims(); ++d) {
+      if (header.shape[d] != layout->shape()[d]) {
+        close(fd);
+        throw std::runtime_error("restore_checkpoint: " + filename
+                                 + " shape does not match layout");
+      }
+    }
+    const std::size_t payload = std::size_t(layout->volume()) * sizeof(T);
+    char* data = reinterpret_cast<char*>(&lattice[0]);
+    std::size_t total_read = 0;
+    while (total_read < payload) {
+      const ssize_t ret = pread(fd, data + total_read, payload - total_read,
+                                header.data_offset + total_read);
+      if (ret <= 0) {
+        close(fd);
+        throw std::runtime_error("restore_checkpoint: " + filename
+                                 + " truncated");
+      }
+      total_read += ret;
+    }
+    close(fd);
+    seed = header.seed;
+    update_num = header.update_num;
+    return header.checkpoint_id;
+  }
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef ENSEMBLE_LOADER_HPP
+#define ENSEMBLE_LOADER_HPP
+
+/* This file provides a double-buffered loader for measurement sweeps over
+ * ensembles of configurations in the lattice file format of lattice_file.hpp.
+ * While the caller measures on the current configuration, a background thread
+ * prefetches the next file into a second buffer; next() then just waits for
+ * the prefetch (usually already complete), swaps the buffers and starts the
+ * one after. Load latency thus overlaps with compute, and only two lattice
+ * buffers exist regardless of ensemble size.
+ */
+
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/lattice.hpp>
+#include <core/layout.hpp>
+
+#include "lattice_file.hpp"
+
+
+namespace pyQCD
+{
+  template <typename T, template <typename> class Alloc = std::allocator>
+  class EnsembleLoader
+  {
+  public:
+    // All files must hold lattices matching the supplied Layout's shape and
+    // element type; this is checked as each file is read.
+    EnsembleLoader(const Layout& layout,
+                   const std::vector<std::string>& filenames)
+      : layout_(&layout), filenames_(filenames), next_file_(0),
+        front_(layout), back_(layout), ready_(false), failed_(false)
+    {
+      start_prefetch();
+    }
+    EnsembleLoader(const EnsembleLoader&) = delete;
+    EnsembleLoader& operator=(const EnsembleLoader&) = delete;
+
+    ~EnsembleLoader()
+    {
+      if (prefetch_thread_.joinable()) {
+        prefetch_thread_.join();
+      }
+    }
+
+    // Number of configurations not yet returned by next()
+    unsigned int remaining() const
+    {
+      return static_cast<unsigned int>(filenames_.size()) - next_file_
+        + (prefetch_thread_.joinable() ? 1 : 0);
+    }
+
+    bool has_next() const
+    { return prefetch_thread_.joinable() or next_file_ < filenames_.size(); }
+
+    // Block until the prefetched configuration is ready, make it current and
+    // start loading the following one. The returned reference stays valid
+    // until the next call to next().
+    const Lattice<T, Alloc>& next()
+    {
+      pyQCDassert ((has_next()),
+        std::out_of_range("EnsembleLoader::next(): ensemble exhausted"));
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_cond_.wait(lock, [this] () { return ready_; });
+      }
+      prefetch_thread_.join();
+      if (failed_) {
+        throw std::runtime_error(error_);
+      }
+      front_.swap(back_);
+      start_prefetch();
+      return front_;
+    }
+
+  private:
+    void start_prefetch()
+    {
+      if (next_file_ >= filenames_.size()) {
+        return;
+      }
+      ready_ = false;
+      const std::string filename = filenames_[next_file_++];
+      prefetch_thread_ = std::thread([this, filename] () {
+        bool failed = false;
+        std::string error;
+        try {
+          load(filename, back_);
+        }
+        catch (const std::exception& e) {
+          failed = true;
+          error = e.what();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_ = failed;
+        error_ = error;
+        ready_ = true;
+        ready_cond_.notify_one();
+      });
+    }
+
+    void load(const std::string& filename, Lattice<T, Alloc>& lattice) const
+    {
+      MappedLattice<T> mapped(filename);
+      if (mapped.shape() != layout_->shape()) {
+        throw std::runtime_error("EnsembleLoader: " + filename
+                                 + " does not match the ensemble shape");
+      }
+      std::memcpy(&lattice[0], mapped.data(),
+                  mapped.volume() * sizeof(T));
+    }
+
+    const Layout* layout_;
+    std::vector<std::string> filenames_;
+    unsigned int next_file_;
+    Lattice<T, Alloc> front_, back_;
+    std::thread prefetch_thread_;
+    std::mutex mutex_;
+    std::condition_variable ready_cond_;
+    bool ready_, failed_;
+    std::string error_;
+  };
+}
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef LATTICE_FILE_HPP
+#define LATTICE_FILE_HPP
+
+/* This file defines the pyQCD binary on-disk lattice format and provides
+ * zero-copy access to it. The payload is the raw element array in the same
+ * order as the in-memory Layout of the writing Lattice, so a configuration
+ * can be memory-mapped and used directly: loading costs one mmap call, pages
+ * are faulted in on demand and shared between concurrent jobs by the OS page
+ * cache.
+ *
+ * A streaming importer for raw big-endian gauge-field payloads (the byte
+ * ordering used by Chroma/ILDG binaries) is provided to convert external
+ * configurations into this format once, after which all reads are free.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <core/lattice.hpp>
+#include <core/layout.hpp>
+
+
+namespace pyQCD
+{
+  struct LatticeFileHeader
+  {
+    char magic[8];              // "pyQCDlat"
+    std::uint32_t version;
+    std::uint32_t layout_tag;   // 0 = lexicographic, 1 = even-odd
+    std::uint32_t num_dims;
+    std::uint32_t element_size;
+    std::uint32_t shape[8];
+    std::uint32_t data_offset;  // byte offset of the element array
+  };
+
+  namespace detail
+  {
+    const char lattice_file_magic[8]
+      = {'p', 'y', 'Q', 'C', 'D', 'l', 'a', 't'};
+    const std::uint32_t lattice_file_version = 1;
+    const std::uint32_t lattice_file_data_offset = 64;
+  }
+
+
+  // Write the lattice in its in-memory (array) order, recording the layout
+  // ordering in the header so readers can reconstruct a matching Layout
+  template <typename T, template <typename> class Alloc>
+  void write_lattice(const Lattice<T, Alloc>& lattice,
+                     const std::string& filename,
+                     const std::uint32_t layout_tag = 0)
+  {
+    const Layout* layout = lattice.layout();
+    pyQCDassert ((layout->num_dims() <= 8),
+      std::invalid_argument("write_lattice supports at most 8 dimensions"));
+    LatticeFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, detail::lattice_file_magic, 8);
+    header.version = detail::lattice_file_version;
+    header.layout_tag = layout_tag;
+    header.num_dims = layout->num_dims();
+    header.element_size = sizeof(T);
+    for (unsigned int d = 0; d < layout->num_dims(); ++d) {
+      header.shape[d] = layout->shape()[d];
+    }
+    header.data_offset = detail::lattice_file_data_offset;
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    if (not file.good()) {
+      throw std::runtime_error("write_lattice: cannot open " + filename);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<char> padding(header.data_offset - sizeof(header), 0);
+    file.write(&padding[0], padding.size());
+    file.write(reinterpret_cast<const char*>(&lattice[0]),
+               static_cast<std::streamsize>(lattice.size() * sizeof(T)));
+  }
+
+
+  template <typename T>
+  class MappedLattice
+  {
+    // Read-only zero-copy view of a lattice file. The element array is
+    // memory-mapped, so operator[] indexes the file's pages directly with
+    // the same array indices as the Lattice that wrote it.
+  public:
+    MappedLattice(const std::string& filename)
+      : mapping_(MAP_FAILED), file_size_(0)
+    {
+      int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+        throw std::runtime_error("MappedLattice: cannot open " + filename);
+      }
+      struct stat file_stat;
+      fstat(fd, &file_stat);
+      file_size_ = static_cast<std::size_t>(file_stat.st_size);
+      mapping_ = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if (mapping_ == MAP_FAILED) {
+        throw std::runtime_error("MappedLattice: mmap failed on " + filename);
+      }
+      std::memcpy(&header_, mapping_, sizeof(header_));
+      if (std::memcmp(header_.magic, detail::lattice_file_magic, 8) != 0
+          or header_.element_size != sizeof(T)) {
+        munmap(mapping_, file_size_);
+        mapping_ = MAP_FAILED;
+        throw std::runtime_error("MappedLattice: " + filename
+                                 + " is not a lattice file of this type");
+      }
+    }
+    MappedLattice(const MappedLattice&) = delete;
+    MappedLattice& operator=(const MappedLattice&) = delete;
+    ~MappedLattice()
+    {
+      if (mapping_ != MAP_FAILED) {
+        munmap(mapping_, file_size_);
+      }
+    }
+
+    const T* data() const
+    {
+      return reinterpret_cast<const T*>(
+        static_cast<const char*>(mapping_) + header_.data_offset);
+    }
+    const T& operator[](const unsigned long i) const { return data()[i]; }
+
+    unsigned int num_dims() const { return header_.num_dims; }
+    std::uint32_t layout_tag() const { return header_.layout_tag; }
+    std::vector<unsigned int> shape() const
+    {
+      return std::vector<unsigned int>(header_.shape,
+                                       header_.shape + header_.num_dims);
+    }
+    unsigned long volume() const
+    {
+      unsigned long ret = 1;
+      for (unsigned int d = 0; d < header_.num_dims; ++d) {
+        ret *= header_.shape[d];
+      }
+      return ret;
+    }
+
+  private:
+    LatticeFileHeader header_;
+    void* mapping_;
+    std::size_t file_size_;
+  };
+
+
+  namespace detail
+  {
+    template <typename Real>
+    Real swap_endian(Real value)
+    {
+      char* bytes = reinterpret_cast<char*>(&value);
+      for (unsigned int i = 0; i < sizeof(Real) / 2; ++i) {
+        std::swap(bytes[i], bytes[sizeof(Real) - 1 - i]);
+      }
+      return value;
+    }
+  }
+
+
+  // Streaming import of a raw gauge-field payload: per site in lexicographic
+  // order, per dimension, a row-major 3x3 complex matrix of big-endian reals
+  // (the payload layout of Chroma/ILDG binaries). The LIME/XML envelope of a
+  // full ILDG file is not parsed here; the caller supplies the bare payload.
+  // gauge_field must arrive sized with one Lattice per dimension, all sharing
+  // a Layout whose site order matches the file.
+  template <typename Real, template <typename> class Alloc>
+  void import_raw_gauge_field(
+    const std::string& filename,
+    std::vector<Lattice<Eigen::Matrix<std::complex<Real>, 3, 3>,
+                        Alloc> >& gauge_field,
+    const bool big_endian = true)
+  {
+    const Layout* layout = gauge_field[0].layout();
+    const unsigned int ndims = layout->num_dims();
+    pyQCDassert ((gauge_field.size() == ndims),
+      std::invalid_argument("gauge_field.size() != num_dims()"));
+
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if (not file.good()) {
+      throw std::runtime_error("import_raw_gauge_field: cannot open "
+                               + filename);
+    }
+    std::vector<Real> site_buffer(ndims * 18);
+    for (unsigned int site_index = 0;
+         site_index < layout->volume();
+         ++site_index) {
+      file.read(reinterpret_cast<char*>(&site_buffer[0]),
+                static_cast<std::streamsize>(site_buffer.size()
+                                             * sizeof(Real)));
+      if (not file.good()) {
+        throw std::runtime_error("import_raw_gauge_field: " + filename
+                                 + " truncated");
+      }
+      const unsigned int array_index = layout->get_array_index(site_index);
+      for (unsigned int mu = 0; mu < ndims; ++mu) {
+        for (unsigned int row = 0; row < 3; ++row) {
+          for (unsigned int col = 0; col < 3; ++col) {
+            Real re = site_buffer[mu * 18 + (row * 3 + col) * 2];
+            Real im = site_buffer[mu * 18 + (row * 3 + col) * 2 + 1];
+            if (big_endian) {
+              re = detail::swap_endian(re);
+              im = detail::swap_endian(im);
+            }
+            gauge_field[mu][array_index](row, col)
+              = std::complex<Real>(re, im);
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif
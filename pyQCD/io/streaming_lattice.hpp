@@ -0,0 +1,204 @@
+#ifndef STREAMING_LATTICE_HPP
+#define STREAMING_LATTICE_HPP
+
+/* This file provides an out-of-core storage backend for lattices larger than
+ * node memory. A StreamingLattice keeps the element array on disk in the
+ * lattice-file format of lattice_file.hpp (so files interoperate with
+ * write_lattice and MappedLattice) and processes it in layout-order chunks:
+ * sweep() hands each chunk to the caller's kernel as an Array, so the
+ * expression templates and reductions apply unchanged, while a background
+ * thread reads the next chunk ahead of the kernel - the same double-buffered
+ * overlap as the EnsembleLoader. An analysis that cannot fit its field in
+ * RAM thus runs at sequential disk bandwidth instead of not at all.
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <core/array.hpp>
+#include <core/layout.hpp>
+#include <utils/macros.hpp>
+
+#include "lattice_file.hpp"
+
+
+namespace pyQCD
+{
+  template <typename T, template <typename> class Alloc = std::allocator>
+  class StreamingLattice
+  {
+  public:
+    // Open the file if it already holds a matching lattice, otherwise create
+    // it (sparse) with the given geometry. chunk_volume is the number of
+    // sites held in memory per buffer; two buffers are live during a sweep.
+    StreamingLattice(const std::string& filename, const Layout& layout,
+                     const unsigned int chunk_volume = 1024 * 1024)
+      : layout_(&layout), chunk_volume_(chunk_volume), fd_(-1)
+    {
+      pyQCDassert ((chunk_volume > 0),
+        std::invalid_argument("StreamingLattice: chunk_volume == 0"));
+      fd_ = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+      if (fd_ < 0) {
+        throw std::runtime_error("StreamingLattice: cannot open " + filename);
+      }
+      LatticeFileHeader header;
+      if (pread(fd_, &header, sizeof(header), 0) == sizeof(header)
+          and std::memcmp(header.magic, detail::lattice_file_magic, 8) == 0) {
+        // Existing lattice file: geometry must match
+        bool matches = header.element_size == sizeof(T)
+          and header.num_dims == layout.num_dims();
+        for (unsigned int d = 0; matches and d < layout.num_dims(); ++d) {
+          matches = header.shape[d] == layout.shape()[d];
+        }
+        if (not matches) {
+          close(fd_);
+          throw std::runtime_error("StreamingLattice: " + filename
+                                   + " does not match the supplied layout");
+        }
+        data_offset_ = header.data_offset;
+      }
+      else {
+        pyQCDassert ((layout.num_dims() <= 8),
+          std::invalid_argument(
+            "StreamingLattice supports at most 8 dimensions"));
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, detail::lattice_file_magic, 8);
+        header.version = detail::lattice_file_version;
+        header.num_dims = layout.num_dims();
+        header.element_size = sizeof(T);
+        for (unsigned int d = 0; d < layout.num_dims(); ++d) {
+          header.shape[d] = layout.shape()[d];
+        }
+        header.data_offset = detail::lattice_file_data_offset;
+        data_offset_ = header.data_offset;
+        if (pwrite(fd_, &header, sizeof(header), 0) != sizeof(header)) {
+          close(fd_);
+          throw std::runtime_error("StreamingLattice: cannot write "
+                                   + filename);
+        }
+        // Size the payload without touching it: unwritten chunks read back
+        // as zero from the file hole
+        ftruncate(fd_, data_offset_
+                       + std::size_t(layout.volume()) * sizeof(T));
+      }
+    }
+    StreamingLattice(const StreamingLattice&) = delete;
+    StreamingLattice& operator=(const StreamingLattice&) = delete;
+    ~StreamingLattice()
+    {
+      if (fd_ >= 0) {
+        close(fd_);
+      }
+    }
+
+    // Streaming sweep: fn(chunk, chunk_begin) receives each chunk in array
+    // order as a mutable Array (so expression templates apply) together with
+    // the array index of its first site, and the chunk is written back after
+    // the kernel returns. The next chunk is read ahead on a background
+    // thread while fn runs on the current one.
+    template <typename Fn>
+    void sweep(Fn fn)
+    { sweep_impl(fn, true); }
+
+    // Read-only sweep: as above, without the write-back
+    template <typename Fn>
+    void sweep(Fn fn) const
+    {
+      const_cast<StreamingLattice*>(this)->sweep_impl(
+        [&fn] (Array<T, Alloc>& chunk, const unsigned long chunk_begin)
+        { fn(static_cast<const Array<T, Alloc>&>(chunk), chunk_begin); },
+        false);
+    }
+
+    unsigned int volume() const { return layout_->volume(); }
+    unsigned int chunk_volume() const { return chunk_volume_; }
+    unsigned int num_chunks() const
+    { return (layout_->volume() - 1) / chunk_volume_ + 1; }
+    const Layout* layout() const { return layout_; }
+
+  private:
+    template <typename Fn>
+    void sweep_impl(Fn fn, const bool write_back)
+    {
+      const unsigned long volume = layout_->volume();
+      Array<T, Alloc> current(chunk_volume_, T()), next(chunk_volume_, T());
+      unsigned long begin = 0;
+      unsigned long current_size = read_chunk(current, 0);
+      while (begin < volume) {
+        const unsigned long next_begin = begin + current_size;
+        std::thread prefetch;
+        unsigned long next_size = 0;
+        if (next_begin < volume) {
+          prefetch = std::thread([this, &next, &next_size, next_begin] ()
+            { next_size = read_chunk(next, next_begin); });
+        }
+        fn(current, begin);
+        if (write_back) {
+          write_chunk(current, begin);
+        }
+        if (prefetch.joinable()) {
+          prefetch.join();
+        }
+        if (next_begin >= volume) {
+          break;
+        }
+        current.swap(next);
+        current_size = next_size;
+        begin = next_begin;
+      }
+    }
+
+    // Read the chunk starting at the given array index, resizing the buffer
+    // to the number of sites actually in it; returns that count
+    unsigned long read_chunk(Array<T, Alloc>& buffer,
+                             const unsigned long begin)
+    {
+      const unsigned long count
+        = (begin + chunk_volume_ < layout_->volume())
+          ? chunk_volume_ : layout_->volume() - begin;
+      buffer.resize(count);
+      const std::size_t size = count * sizeof(T);
+      char* data = reinterpret_cast<char*>(&buffer[0]);
+      std::size_t total_read = 0;
+      while (total_read < size) {
+        const ssize_t ret = pread(fd_, data + total_read, size - total_read,
+                                  data_offset_ + begin * sizeof(T)
+                                  + total_read);
+        if (ret <= 0) {
+          throw std::runtime_error("StreamingLattice: read failed");
+        }
+        total_read += ret;
+      }
+      return count;
+    }
+
+    void write_chunk(const Array<T, Alloc>& buffer, const unsigned long begin)
+    {
+      const std::size_t size = buffer.size() * sizeof(T);
+      const char* data = reinterpret_cast<const char*>(&buffer[0]);
+      std::size_t written = 0;
+      while (written < size) {
+        const ssize_t ret = pwrite(fd_, data + written, size - written,
+                                   data_offset_ + begin * sizeof(T)
+                                   + written);
+        if (ret < 0) {
+          throw std::runtime_error("StreamingLattice: write failed");
+        }
+        written += ret;
+      }
+    }
+
+    const Layout* layout_;
+    unsigned int chunk_volume_;
+    int fd_;
+    std::uint64_t data_offset_;
+  };
+}
+
+#endif
@@ -2,20 +2,56 @@
 #define TYPES_HPP
 
 #include "array.hpp"
+#include "gamma.hpp"
 #include "matrix_array.hpp"
 #include "lattice.hpp"
+#include "lattice_cast.hpp"
+#include "../gauge/compressed_link.hpp"
 
 
-typedef {{ precision }} Real;
-typedef std::complex<{{ precision }}> Complex;
-typedef pyQCD::Array<Complex> ComplexArray;
-typedef pyQCD::Lattice<Complex> LatticeComplex;
-typedef pyQCD::Lattice<pyQCD::Array<Complex> > LatticeComplexArray;
+{% for prec, suffix in [("float", "F"), ("double", "D")] %}
+typedef {{ prec }} Real{{ suffix }};
+typedef std::complex<{{ prec }}> Complex{{ suffix }};
+typedef pyQCD::Array<Complex{{ suffix }}> ComplexArray{{ suffix }};
+typedef pyQCD::Lattice<Complex{{ suffix }}> LatticeComplex{{ suffix }};
+typedef pyQCD::Lattice<pyQCD::Array<Complex{{ suffix }}> > LatticeComplexArray{{ suffix }};
 {% for matrix in matrixdefs %}
-typedef Eigen::Matrix<Complex, {{ matrix.num_rows }}, {{ matrix.num_cols }}> {{ matrix.matrix_name }};
-typedef pyQCD::MatrixArray<{{ matrix.num_rows }}, {{ matrix.num_cols }}, {{ precision }}> {{ matrix.array_name }};
-typedef pyQCD::Lattice<Eigen::Matrix<Complex, {{ matrix.num_rows }}, {{ matrix.num_cols }}>, Eigen::aligned_allocator> {{ matrix.lattice_matrix_name }};
-typedef pyQCD::Lattice<pyQCD::MatrixArray<{{ matrix.num_rows }}, {{ matrix.num_cols }}, {{ precision }}> > {{ matrix.lattice_array_name }};
+typedef Eigen::Matrix<Complex{{ suffix }}, {{ matrix.num_rows }}, {{ matrix.num_cols }}> {{ matrix.matrix_name }}{{ suffix }};
+typedef pyQCD::MatrixArray<{{ matrix.num_rows }}, {{ matrix.num_cols }}, {{ prec }}> {{ matrix.array_name }}{{ suffix }};
+typedef pyQCD::Lattice<Eigen::Matrix<Complex{{ suffix }}, {{ matrix.num_rows }}, {{ matrix.num_cols }}>, Eigen::aligned_allocator> {{ matrix.lattice_matrix_name }}{{ suffix }};
+typedef pyQCD::Lattice<pyQCD::MatrixArray<{{ matrix.num_rows }}, {{ matrix.num_cols }}, {{ prec }}> > {{ matrix.lattice_array_name }}{{ suffix }};
+{% if matrix.num_rows == 3 and matrix.num_cols == 3 %}
+typedef pyQCD::CompressedColourMatrix3<{{ prec }}> Compressed{{ matrix.matrix_name }}{{ suffix }};
+typedef pyQCD::Lattice<pyQCD::CompressedColourMatrix3<{{ prec }}> > {{ matrix.lattice_matrix_name }}Compressed{{ suffix }};
+{% endif %}
+{% endfor %}
+{% endfor %}
+
+{# The unsuffixed names stay bound to the build precision, so existing code
+   and the Cython layer are unaffected by the dual-precision family. #}
+{% set suffix = "F" if precision == "float" else "D" %}
+typedef Real{{ suffix }} Real;
+typedef Complex{{ suffix }} Complex;
+typedef ComplexArray{{ suffix }} ComplexArray;
+typedef LatticeComplex{{ suffix }} LatticeComplex;
+typedef LatticeComplexArray{{ suffix }} LatticeComplexArray;
+{% for matrix in matrixdefs %}
+typedef {{ matrix.matrix_name }}{{ suffix }} {{ matrix.matrix_name }};
+typedef {{ matrix.array_name }}{{ suffix }} {{ matrix.array_name }};
+typedef {{ matrix.lattice_matrix_name }}{{ suffix }} {{ matrix.lattice_matrix_name }};
+typedef {{ matrix.lattice_array_name }}{{ suffix }} {{ matrix.lattice_array_name }};
+{% if matrix.num_rows == 3 and matrix.num_cols == 3 %}
+typedef Compressed{{ matrix.matrix_name }}{{ suffix }} Compressed{{ matrix.matrix_name }};
+typedef {{ matrix.lattice_matrix_name }}Compressed{{ suffix }} {{ matrix.lattice_matrix_name }}Compressed;
+{% endif %}
+{% endfor %}
+
+{# Fixed-dimension layouts for this build: the dimension count (and, for any
+   configured production volumes, the full shape) is a compile-time constant,
+   so coordinate indexing unrolls to constexpr-stride multiply-adds. #}
+typedef pyQCD::FixedLexicoLayout<{{ num_dims }}> LexicoLayout{{ num_dims }}D;
+{% for shape in static_shapes %}
+typedef pyQCD::ConstShapeLexicoLayout<{{ shape|join(", ") }}> LexicoLayout{{ shape|join("x") }};
 {% endfor %}
 
 {% for matrix in matrixdefs %}
@@ -26,4 +62,4 @@ inline void mat_assign({{ matrix.matrix_name }}& mat, const int i, const int j,
 {% endif %}
 {% endfor %}
 
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,7 @@
 #define HELPERS_HPP
 
 #include <cmath>
+#include <random>
 
 #include "catch.hpp"
 
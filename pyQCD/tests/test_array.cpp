@@ -70,6 +70,41 @@ TEST_CASE("Array test") {
     }
   }
 
+  SECTION ("Testing scalar operand value capture") {
+    // The scalar here is a local that dies before the expression is
+    // evaluated; ArrayConst must have captured it by value
+    auto make_expr = [&array1] () {
+      double scalar = 5.0;
+      return array1 * scalar;
+    };
+    Arr result = make_expr();
+    for (int i = 0; i < 100; ++i) {
+      REQUIRE (result[i] == 5.0);
+    }
+  }
+
+  SECTION ("Testing move-aware binary ops") {
+    double* buffer = &array1[0];
+    Arr result = std::move(array1) + array2;
+    // The expiring operand's buffer is reused for the result
+    REQUIRE (&result[0] == buffer);
+    for (int i = 0; i < 100; ++i) {
+      REQUIRE (result[i] == 3.0);
+    }
+    buffer = &result[0];
+    result = std::move(result) * 2.0;
+    REQUIRE (&result[0] == buffer);
+    for (int i = 0; i < 100; ++i) {
+      REQUIRE (result[i] == 6.0);
+    }
+  }
+
+  SECTION ("Testing swap") {
+    array1.swap(array2);
+    REQUIRE (array1[0] == 2.0);
+    REQUIRE (array2[0] == 1.0);
+  }
+
   SECTION ("Testing array-array op-assigns") {
     array1 += array2;
     for (int i = 0; i < 100; ++i) {
@@ -109,6 +144,65 @@ TEST_CASE("Array test") {
   }
 }
 
+TEST_CASE("Reduction test") {
+  const int n = 4 * PYQCD_PARALLEL_THRESHOLD;
+  Arr array1(n, 1.5);
+  Arr array2(n, 2.0);
+
+  SECTION ("Testing sum") {
+    REQUIRE (pyQCD::sum(array1) == 1.5 * n);
+    // Reductions fuse with the expression templates: no temporary Array
+    REQUIRE (pyQCD::sum(array1 + array2) == 3.5 * n);
+    REQUIRE (pyQCD::sum(2.0 * array1) == 3.0 * n);
+  }
+
+  SECTION ("Testing norm2") {
+    REQUIRE (pyQCD::norm2(array2) == 4.0 * n);
+    REQUIRE (pyQCD::norm2(array1 + array2) == 3.5 * 3.5 * n);
+  }
+
+  SECTION ("Testing dot") {
+    REQUIRE (pyQCD::dot(array1, array2) == 3.0 * n);
+    REQUIRE (pyQCD::dot(array1, array1 + array2) == 1.5 * 3.5 * n);
+  }
+
+  SECTION ("Testing complex dot") {
+    pyQCD::Array<std::complex<double> > carray1(
+      100, std::complex<double>(0.0, 1.0));
+    pyQCD::Array<std::complex<double> > carray2(
+      100, std::complex<double>(2.0, 0.0));
+    std::complex<double> result = pyQCD::dot(carray1, carray2);
+    REQUIRE (result.real() == 0.0);
+    REQUIRE (result.imag() == -200.0);
+    REQUIRE (pyQCD::norm2(carray1) == 100.0);
+  }
+}
+
+TEST_CASE("Parallel expression evaluation test") {
+  // Large enough to cross PYQCD_PARALLEL_THRESHOLD, so the assignment loops
+  // are dispatched to the shared thread pool
+  const int n = 16 * PYQCD_PARALLEL_THRESHOLD;
+  Arr array1(n, 1.0);
+  Arr array2(n, 2.0);
+
+  Arr array3 = array1 + 2.0 * array2;
+  for (int i = 0; i < n; ++i) {
+    REQUIRE (array3[i] == 5.0);
+  }
+  array3 = array1 - array2;
+  for (int i = 0; i < n; ++i) {
+    REQUIRE (array3[i] == -1.0);
+  }
+  array3 += array2;
+  for (int i = 0; i < n; ++i) {
+    REQUIRE (array3[i] == 1.0);
+  }
+  array3 *= 4.0;
+  for (int i = 0; i < n; ++i) {
+    REQUIRE (array3[i] == 4.0);
+  }
+}
+
 TEST_CASE("Non-integral Array types test") {
   pyQCD::Array<Eigen::Matrix3cd> array1(4, Eigen::Matrix3cd::Identity());
   Eigen::Vector3cd vec(1.0, 1.0, 1.0);
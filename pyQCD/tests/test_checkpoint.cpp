@@ -0,0 +1,92 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstdio>
+
+#include <io/checkpoint.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("Checkpoint test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  const unsigned int block_size = 32;
+  const unsigned int num_blocks = layout.volume() / block_size;
+
+  pyQCD::Lattice<double> lattice(layout, 0.0);
+  for (unsigned int i = 0; i < layout.volume(); ++i) {
+    lattice[i] = 1.5 * i;
+  }
+
+  SECTION("Test save/restore round trip") {
+    pyQCD::Checkpointer<double> checkpointer(
+      "test_checkpoint.bin", layout, block_size);
+    // First save is a full write
+    REQUIRE(checkpointer.save(lattice, 42, 100) == num_blocks);
+    REQUIRE(checkpointer.checkpoint_id() == 1);
+
+    pyQCD::Lattice<double> restored(layout, 0.0);
+    std::uint64_t seed = 0, update_num = 0;
+    REQUIRE(pyQCD::restore_checkpoint("test_checkpoint.bin", restored,
+                                      seed, update_num) == 1);
+    REQUIRE(seed == 42);
+    REQUIRE(update_num == 100);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(restored[i] == lattice[i]);
+    }
+    std::remove("test_checkpoint.bin");
+  }
+
+  SECTION("Test incremental writes") {
+    pyQCD::Checkpointer<double> checkpointer(
+      "test_checkpoint.bin", layout, block_size);
+    checkpointer.save(lattice, 42, 100);
+    // Nothing changed: no blocks rewritten
+    REQUIRE(checkpointer.save(lattice, 42, 101) == 0);
+    // Touch one site: exactly its block is rewritten
+    lattice[3 * block_size + 7] += 1.0;
+    REQUIRE(checkpointer.save(lattice, 42, 102) == 1);
+
+    pyQCD::Lattice<double> restored(layout, 0.0);
+    std::uint64_t seed = 0, update_num = 0;
+    REQUIRE(pyQCD::restore_checkpoint("test_checkpoint.bin", restored,
+                                      seed, update_num) == 3);
+    REQUIRE(update_num == 102);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(restored[i] == lattice[i]);
+    }
+    std::remove("test_checkpoint.bin");
+  }
+
+  SECTION("Test resume against existing checkpoint") {
+    {
+      pyQCD::Checkpointer<double> checkpointer(
+        "test_checkpoint.bin", layout, block_size);
+      checkpointer.save(lattice, 42, 100);
+    }
+    // A fresh Checkpointer (a restarted job) reloads the hash table and
+    // continues writing deltas
+    pyQCD::Checkpointer<double> resumed(
+      "test_checkpoint.bin", layout, block_size);
+    REQUIRE(resumed.checkpoint_id() == 1);
+    REQUIRE(resumed.save(lattice, 42, 101) == 0);
+    lattice[0] += 1.0;
+    REQUIRE(resumed.save(lattice, 42, 102) == 1);
+    std::remove("test_checkpoint.bin");
+  }
+
+  SECTION("Test geometry checks on restore") {
+    pyQCD::Checkpointer<double> checkpointer(
+      "test_checkpoint.bin", layout, block_size);
+    checkpointer.save(lattice, 42, 100);
+    std::uint64_t seed = 0, update_num = 0;
+
+    pyQCD::LexicoLayout other_layout(std::vector<unsigned int>{8, 4, 4, 4});
+    pyQCD::Lattice<double> wrong_shape(other_layout, 0.0);
+    REQUIRE_THROWS(pyQCD::restore_checkpoint("test_checkpoint.bin",
+                                             wrong_shape, seed, update_num));
+
+    pyQCD::Lattice<float> wrong_type(layout, 0.0f);
+    REQUIRE_THROWS(pyQCD::restore_checkpoint("test_checkpoint.bin",
+                                             wrong_type, seed, update_num));
+    std::remove("test_checkpoint.bin");
+  }
+}
@@ -0,0 +1,45 @@
+#define CATCH_CONFIG_MAIN
+
+#include <gauge/compressed_link.hpp>
+#include <gauge/smearing.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::CompressedColourMatrix3<double> CompressedLink;
+
+TEST_CASE("CompressedColourMatrix3 test") {
+  MatrixCompare<Eigen::Matrix3cd> comparison(1.0e-10, 1.0e-13);
+  MatrixCompare<Eigen::Vector3cd> vec_comparison(1.0e-10, 1.0e-13);
+
+  Eigen::Matrix3cd link = pyQCD::project_su3<double>(
+    Eigen::Matrix3cd::Random());
+  CompressedLink compressed = CompressedLink::compress(link);
+
+  SECTION("Test reconstruction") {
+    REQUIRE(comparison(compressed.reconstruct(), link));
+  }
+
+  SECTION("Test multiply kernels") {
+    Eigen::Vector3cd vec = Eigen::Vector3cd::Random();
+    REQUIRE(vec_comparison(compressed * vec, link * vec));
+    REQUIRE(vec_comparison(compressed.adjoint_multiply(vec),
+                           (link.adjoint() * vec).eval()));
+  }
+
+  SECTION("Test whole-field compression") {
+    pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+    pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+      gauge_field(layout);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      gauge_field[i] = pyQCD::project_su3<double>(Eigen::Matrix3cd::Random());
+    }
+    pyQCD::Lattice<CompressedLink> compressed_field
+      = pyQCD::compress_gauge_field(gauge_field);
+    pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+      reconstructed(layout);
+    pyQCD::reconstruct_gauge_field(compressed_field, reconstructed);
+    for (unsigned int i = 0; i < layout.volume(); i += 19) {
+      REQUIRE(comparison(reconstructed[i], gauge_field[i]));
+    }
+  }
+}
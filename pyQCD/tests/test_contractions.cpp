@@ -0,0 +1,71 @@
+#define CATCH_CONFIG_MAIN
+
+#include <fermions/contractions.hpp>
+
+#include "helpers.hpp"
+
+typedef std::complex<double> Complex;
+typedef pyQCD::MatrixArray<3, 1, double> SiteFermion;
+typedef pyQCD::Lattice<SiteFermion> FermionField;
+
+TEST_CASE("Contraction engine test") {
+  const std::vector<unsigned int> shape{8, 4, 4, 4};
+  pyQCD::LexicoLayout layout(shape);
+  const unsigned int spatial_volume = layout.volume() / shape[0];
+
+  SiteFermion ones(4, Eigen::Vector3cd::Ones());
+  FermionField psi1(layout, ones);
+  FermionField psi2(layout, ones);
+  // Scale each site by (t + 1) so the per-timeslice sums are distinguishable
+  for (unsigned int i = 0; i < layout.volume(); ++i) {
+    const unsigned int t = layout.get_site_index(i) / spatial_volume;
+    psi2[i] = ones * static_cast<double>(t + 1);
+  }
+
+  SECTION ("Testing meson correlator") {
+    std::vector<Complex> correlator = pyQCD::meson_correlator(psi1, psi2);
+    REQUIRE (correlator.size() == shape[0]);
+    // Each site contributes 4 spins x 3 colours x (t + 1)
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      REQUIRE (correlator[t].real() == 12.0 * (t + 1) * spatial_volume);
+      REQUIRE (correlator[t].imag() == 0.0);
+    }
+  }
+
+  SECTION ("Testing generic two-operand contraction") {
+    auto correlator = pyQCD::contract_timeslices<Complex>(psi1, psi2,
+      [] (const SiteFermion& site1, const SiteFermion& site2)
+      { return site1[0].dot(site2[0]); });
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      REQUIRE (correlator[t].real() == 3.0 * (t + 1) * spatial_volume);
+    }
+  }
+
+  SECTION ("Testing three-operand contraction") {
+    auto correlator = pyQCD::contract_timeslices<Complex>(psi1, psi2, psi2,
+      [] (const SiteFermion& a, const SiteFermion& b, const SiteFermion& c)
+      { return a[0].dot(b[0]) * c[0][0]; });
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      REQUIRE (correlator[t].real()
+               == 3.0 * (t + 1) * (t + 1) * spatial_volume);
+    }
+  }
+
+  SECTION ("Testing layout independence") {
+    // The timeslice binning goes through get_site_index, so an even-odd
+    // field produces the same correlator as a lexicographic one
+    pyQCD::EvenOddLayout eo_layout(shape);
+    FermionField eo_psi1(eo_layout, ones);
+    FermionField eo_psi2(eo_layout, ones);
+    for (unsigned int i = 0; i < eo_layout.volume(); ++i) {
+      const unsigned int t = eo_layout.get_site_index(i) / spatial_volume;
+      eo_psi2[i] = ones * static_cast<double>(t + 1);
+    }
+    std::vector<Complex> lexico = pyQCD::meson_correlator(psi1, psi2);
+    std::vector<Complex> even_odd = pyQCD::meson_correlator(eo_psi1, eo_psi2);
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      REQUIRE (lexico[t].real() == even_odd[t].real());
+      REQUIRE (lexico[t].imag() == even_odd[t].imag());
+    }
+  }
+}
@@ -0,0 +1,36 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/device_lattice.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("DeviceLattice test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  pyQCD::Lattice<double> lattice(layout, 0.0);
+  for (unsigned int i = 0; i < layout.volume(); ++i) {
+    lattice[i] = 2.0 * i;
+  }
+
+  SECTION("Test upload/download round trip") {
+    pyQCD::DeviceLattice<double> device_lattice(lattice);
+    pyQCD::Lattice<double> result(layout, 0.0);
+    device_lattice.download(result);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(result[i] == lattice[i]);
+    }
+  }
+
+  SECTION("Test resident kernel execution") {
+    pyQCD::DeviceLattice<double> device_lattice(lattice);
+    // Two kernels back to back with no intermediate transfer
+    device_lattice.for_each_site(
+      [] (double& value, const unsigned int) { value *= 3.0; });
+    device_lattice.for_each_site(
+      [] (double& value, const unsigned int i) { value += i; });
+    pyQCD::Lattice<double> result(layout, 0.0);
+    device_lattice.download(result);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(result[i] == 6.0 * i + i);
+    }
+  }
+}
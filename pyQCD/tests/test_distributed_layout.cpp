@@ -0,0 +1,68 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/distributed_layout.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("DistributedLayout test") {
+  std::vector<unsigned int> global_shape{8, 4, 4, 4};
+  std::vector<unsigned int> ranks{1, 1, 1, 1};
+  pyQCD::DistributedLayout layout(global_shape, ranks, 0);
+
+  SECTION("Test shapes and site partitions") {
+    std::vector<unsigned int> padded_shape{10, 6, 6, 6};
+    REQUIRE (layout.local_shape() == global_shape);
+    REQUIRE (layout.shape() == padded_shape);
+    REQUIRE (layout.volume() == 10 * 6 * 6 * 6);
+    REQUIRE (layout.owned_indices().size() == 8 * 4 * 4 * 4);
+    REQUIRE (layout.interior_indices().size() == 6 * 2 * 2 * 2);
+    for (auto i : layout.owned_indices()) {
+      REQUIRE (not layout.is_halo_site(i));
+    }
+    for (unsigned int d = 0; d < 4; ++d) {
+      REQUIRE (layout.neighbour_rank(d, 0) == 0);
+      REQUIRE (layout.halo_indices(d, 0).size()
+                 == layout.boundary_indices(d, 0).size());
+    }
+  }
+
+  SECTION("Test halo exchange") {
+    pyQCD::Lattice<double> lattice(layout, -1.0);
+    // Fill the owned sites with their global lexicographic index
+    std::vector<unsigned int> padded = layout.shape();
+    for (auto i : layout.owned_indices()) {
+      unsigned int remainder = i, global_index = 0;
+      for (unsigned int d = 4; d-- > 0;) {
+        global_index += (remainder % padded[d] - 1)
+          * std::accumulate(global_shape.begin() + d + 1, global_shape.end(),
+                            1u, std::multiplies<unsigned int>());
+        remainder /= padded[d];
+      }
+      lattice[i] = global_index;
+    }
+
+    pyQCD::exchange_halos(lattice);
+
+    // Every neighbour access from an owned site must now see the value of
+    // the periodically wrapped global site
+    pyQCD::LexicoLayout global_layout(global_shape);
+    for (auto i : layout.owned_indices()) {
+      std::vector<unsigned int> coords(4);
+      unsigned int remainder = i;
+      for (unsigned int d = 4; d-- > 0;) {
+        coords[d] = remainder % padded[d] - 1;
+        remainder /= padded[d];
+      }
+      for (unsigned int d = 0; d < 4; ++d) {
+        for (unsigned int direction = 0; direction < 2; ++direction) {
+          std::vector<unsigned int> neighbour = coords;
+          neighbour[d] = (coords[d] + global_shape[d]
+                          + (direction == 0 ? 1 : -1)) % global_shape[d];
+          double expected = global_layout.get_array_index(neighbour);
+          REQUIRE (lattice[layout.get_neighbour_index(i, d, direction)]
+                     == expected);
+        }
+      }
+    }
+  }
+}
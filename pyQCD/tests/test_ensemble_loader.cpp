@@ -0,0 +1,47 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstdio>
+
+#include <io/ensemble_loader.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("EnsembleLoader test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+
+  SECTION("Test prefetched sweep over an ensemble") {
+    std::vector<std::string> filenames;
+    for (unsigned int config = 0; config < 3; ++config) {
+      pyQCD::Lattice<double> lattice(layout, 0.0);
+      for (unsigned int i = 0; i < layout.volume(); ++i) {
+        lattice[i] = 1000.0 * config + i;
+      }
+      std::string filename
+        = "test_ensemble_" + std::to_string(config) + ".bin";
+      pyQCD::write_lattice(lattice, filename);
+      filenames.push_back(filename);
+    }
+
+    pyQCD::EnsembleLoader<double> loader(layout, filenames);
+    for (unsigned int config = 0; config < 3; ++config) {
+      REQUIRE(loader.has_next());
+      const pyQCD::Lattice<double>& lattice = loader.next();
+      REQUIRE(lattice.layout() == &layout);
+      for (unsigned int i = 0; i < layout.volume(); ++i) {
+        REQUIRE(lattice[i] == 1000.0 * config + i);
+      }
+    }
+    REQUIRE(!loader.has_next());
+
+    for (const std::string& filename : filenames) {
+      std::remove(filename.c_str());
+    }
+  }
+
+  SECTION("Test missing file is reported on next()") {
+    pyQCD::EnsembleLoader<double> loader(
+      layout, std::vector<std::string>{"test_ensemble_missing.bin"});
+    REQUIRE(loader.has_next());
+    REQUIRE_THROWS(loader.next());
+  }
+}
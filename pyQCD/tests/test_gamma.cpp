@@ -0,0 +1,57 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/gamma.hpp>
+#include <fermions/wilson_dirac.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::WilsonDiracOperator<double> Dirac;
+
+TEST_CASE("Gamma table test") {
+  SECTION("Test tables against the dense matrices") {
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      const Dirac::SpinMatrix& dense = Dirac::gamma(mu);
+      for (unsigned int alpha = 0; alpha < 4; ++alpha) {
+        for (unsigned int beta = 0; beta < 4; ++beta) {
+          Dirac::Complex expected = (beta == pyQCD::gamma::column[mu][alpha])
+            ? pyQCD::gamma::coefficient<double>(mu, alpha)
+            : Dirac::Complex(0.0);
+          REQUIRE(dense(alpha, beta) == expected);
+        }
+      }
+    }
+  }
+
+  SECTION("Test fused spin projection") {
+    MatrixCompare<Dirac::ColourVector> comparison(1.0e-12, 1.0e-14);
+    Dirac::SiteFermion psi(pyQCD::gamma::num_spins,
+                           Dirac::ColourVector::Zero());
+    for (unsigned int alpha = 0; alpha < pyQCD::gamma::num_spins; ++alpha) {
+      psi[alpha] = Dirac::ColourVector::Random();
+    }
+    Dirac::SiteFermion projected = psi;
+
+    // Dense reference: (1 + sign * gamma_mu) psi, spot-checked for each
+    // direction against the specialized template
+    auto check = [&] (const unsigned int mu, const int sign) {
+      const Dirac::SpinMatrix& gamma_mu = Dirac::gamma(mu);
+      for (unsigned int alpha = 0; alpha < pyQCD::gamma::num_spins;
+           ++alpha) {
+        Dirac::ColourVector expected = psi[alpha];
+        for (unsigned int beta = 0; beta < pyQCD::gamma::num_spins; ++beta) {
+          expected += double(sign) * gamma_mu(alpha, beta) * psi[beta];
+        }
+        REQUIRE(comparison(projected[alpha], expected));
+      }
+    };
+
+    pyQCD::gamma::spin_project<0, -1>(psi, projected);
+    check(0, -1);
+    pyQCD::gamma::spin_project<1, 1>(psi, projected);
+    check(1, 1);
+    pyQCD::gamma::spin_project<2, -1>(psi, projected);
+    check(2, -1);
+    pyQCD::gamma::spin_project<3, 1>(psi, projected);
+    check(3, 1);
+  }
+}
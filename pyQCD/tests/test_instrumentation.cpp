@@ -0,0 +1,46 @@
+#define CATCH_CONFIG_MAIN
+#define PYQCD_INSTRUMENT
+
+#include <sstream>
+
+#include <core/lattice.hpp>
+#include <utils/instrumentation.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("Instrumentation test") {
+  pyQCD::InstrumentationRegistry& registry
+    = pyQCD::InstrumentationRegistry::instance();
+  registry.reset();
+
+  SECTION("Test counter accumulation") {
+    for (unsigned int i = 0; i < 3; ++i) {
+      PYQCD_SCOPED_KERNEL("test kernel", 100, 50);
+    }
+    pyQCD::KernelCounters counters = registry.query("test kernel");
+    REQUIRE(counters.num_calls == 3);
+    REQUIRE(counters.bytes == 300);
+    REQUIRE(counters.flops == 150);
+    REQUIRE(counters.seconds >= 0.0);
+  }
+
+  SECTION("Test annotated expression assignment") {
+    pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+    pyQCD::Lattice<double> lattice1(layout, 1.0);
+    pyQCD::Lattice<double> lattice2(layout, 2.0);
+    lattice1 = lattice1 + lattice2;
+    pyQCD::KernelCounters counters
+      = registry.query("Lattice::operator=(expr)");
+    REQUIRE(counters.num_calls == 1);
+    REQUIRE(counters.bytes == 2 * layout.volume() * sizeof(double));
+  }
+
+  SECTION("Test report") {
+    { PYQCD_SCOPED_KERNEL("reported kernel", 1000, 0); }
+    std::ostringstream stream;
+    registry.report(stream);
+    REQUIRE(stream.str().find("reported kernel") != std::string::npos);
+  }
+
+  registry.reset();
+}
@@ -58,12 +58,93 @@ TEST_CASE("Lattice test") {
     REQUIRE(lattice1[301] == 123.0);
   }
 
+  SECTION("Test gather") {
+    Lattice shifted = bad_lattice.gather(3, 0);
+    // bad_lattice holds the reversed array index at each site, so the
+    // gathered value is the neighbour's array index
+    std::vector<unsigned int> site{0, 0, 0, 0};
+    std::vector<unsigned int> neighbour{0, 0, 0, 1};
+    REQUIRE(shifted(site) == bad_lattice(neighbour));
+    shifted = bad_lattice.gather(0, 1);
+    neighbour = std::vector<unsigned int>{7, 0, 0, 0};
+    REQUIRE(shifted(site) == bad_lattice(neighbour));
+    REQUIRE(shifted.layout() == bad_lattice.layout());
+  }
+
+  SECTION("Test shift expression") {
+    // A bare shift must agree with gather
+    Lattice shifted = pyQCD::shift(bad_lattice, 2, 0);
+    Lattice gathered = bad_lattice.gather(2, 0);
+    for (unsigned int i = 0; i < shifted.volume(); ++i) {
+      REQUIRE(shifted[i] == gathered[i]);
+    }
+    // And compose with elementwise expressions without materializing
+    Lattice hopping
+      = bad_lattice * pyQCD::shift(bad_lattice, 0, 0)
+      + bad_lattice * pyQCD::shift(bad_lattice, 0, 1);
+    std::vector<unsigned int> site{2, 1, 3, 0};
+    std::vector<unsigned int> fwd{3, 1, 3, 0};
+    std::vector<unsigned int> bwd{1, 1, 3, 0};
+    REQUIRE(hopping(site)
+              == bad_lattice(site) * (bad_lattice(fwd) + bad_lattice(bwd)));
+  }
+
+  SECTION("Test parity accessors") {
+    pyQCD::EvenOddLayout eo_layout(std::vector<unsigned int>{8, 4, 4, 4});
+    Lattice eo_lattice(eo_layout, 0.0);
+    std::fill(eo_lattice.parity_begin(0), eo_lattice.parity_end(0), 1.0);
+    std::fill(eo_lattice.parity_begin(1), eo_lattice.parity_end(1), -1.0);
+    REQUIRE(eo_lattice(std::vector<unsigned int>{0, 0, 0, 0}) == 1.0);
+    REQUIRE(eo_lattice(std::vector<unsigned int>{0, 0, 0, 1}) == -1.0);
+    REQUIRE(eo_lattice(std::vector<unsigned int>{1, 1, 0, 0}) == 1.0);
+    REQUIRE(eo_lattice(std::vector<unsigned int>{1, 0, 0, 0}) == -1.0);
+  }
+
   SECTION("Test properties") {
     REQUIRE(lattice1.layout() == &layout);
     REQUIRE(lattice1.volume() == 512);
     REQUIRE(lattice1.num_dims() == 4);
   }
 
+  SECTION("Test same-layout fast-path assignment and swap") {
+    pyQCD::Lattice<double> copy(layout, 0.0);
+    copy = lattice1;  // both on the same Layout object: contiguous copy
+    for (unsigned int i = 0; i < copy.volume(); ++i) {
+      REQUIRE(copy[i] == lattice1[i]);
+    }
+    double* buffer = &copy[0];
+    pyQCD::Lattice<double> other(layout, -1.0);
+    copy.swap(other);
+    REQUIRE(&other[0] == buffer);
+    REQUIRE(copy[0] == -1.0);
+  }
+
+  SECTION("Test move-aware binary ops") {
+    pyQCD::Lattice<double> temp(layout, 3.0);
+    double* buffer = &temp[0];
+    pyQCD::Lattice<double> result = std::move(temp) + lattice1;
+    REQUIRE(&result[0] == buffer);
+    REQUIRE(result.layout() == &layout);
+    for (unsigned int i = 0; i < result.volume(); ++i) {
+      REQUIRE(result[i] == 3.0 + lattice1[i]);
+    }
+  }
+
+  SECTION("Test static layout dispatch") {
+    pyQCD::StaticLexicoLayout static_layout(std::vector<unsigned int>{8, 4,
+                                                                      4, 4});
+    typedef pyQCD::Lattice<double, std::allocator, pyQCD::StaticLexicoLayout>
+      StaticLattice;
+    StaticLattice static_lattice1(static_layout, 2.0);
+    StaticLattice static_lattice2(static_layout, 3.0);
+    // Accessors and expression assignment resolve through the static type
+    REQUIRE(static_lattice1(100) == 2.0);
+    REQUIRE(static_lattice1(std::vector<unsigned int>{4, 3, 2, 1}) == 2.0);
+    static_lattice1 = static_lattice1 + static_lattice2;
+    REQUIRE(static_lattice1[0] == 5.0);
+    REQUIRE(static_lattice1.layout() == &static_layout);
+  }
+
   SECTION("Test non-scalar site types") {
     decltype(lattice_array) result
       = lattice_array * arr.broadcast();
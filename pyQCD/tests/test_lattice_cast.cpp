@@ -0,0 +1,59 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/lattice_cast.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("lattice_cast test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+
+  SECTION("Test scalar lattice conversion") {
+    pyQCD::Lattice<double> lattice(layout, 0.0);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      lattice[i] = 0.5 * i;
+    }
+    pyQCD::Lattice<float> single = pyQCD::lattice_cast<float>(lattice);
+    REQUIRE(single.layout() == &layout);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(single[i] == static_cast<float>(lattice[i]));
+    }
+    // ...and back up to double
+    pyQCD::Lattice<double> restored = pyQCD::lattice_cast<double>(single);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(restored[i] == static_cast<double>(single[i]));
+    }
+  }
+
+  SECTION("Test colour matrix lattice conversion") {
+    pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+      lattice(layout, Eigen::Matrix3cd::Random());
+    auto single = pyQCD::lattice_cast<Eigen::Matrix3cf,
+                                      Eigen::aligned_allocator>(lattice);
+    MatrixCompare<Eigen::Matrix3cf> comparison(1.0e-6, 1.0e-7);
+    for (unsigned int i = 0; i < layout.volume(); i += 19) {
+      REQUIRE(comparison(single[i],
+                         lattice[i].cast<std::complex<float> >().eval()));
+    }
+  }
+
+  SECTION("Test fermion field conversion") {
+    typedef pyQCD::MatrixArray<3, 1, double> SiteFermionD;
+    typedef pyQCD::MatrixArray<3, 1, float> SiteFermionF;
+    pyQCD::Lattice<SiteFermionD> fermion(
+      layout, SiteFermionD(4, Eigen::Vector3cd::Zero()));
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      for (unsigned int alpha = 0; alpha < 4; ++alpha) {
+        fermion[i][alpha] = Eigen::Vector3cd::Random();
+      }
+    }
+    auto single = pyQCD::lattice_cast<SiteFermionF>(fermion);
+    MatrixCompare<Eigen::Vector3cf> comparison(1.0e-6, 1.0e-7);
+    for (unsigned int i = 0; i < layout.volume(); i += 19) {
+      for (unsigned int alpha = 0; alpha < 4; ++alpha) {
+        REQUIRE(comparison(
+          single[i][alpha],
+          fermion[i][alpha].cast<std::complex<float> >().eval()));
+      }
+    }
+  }
+}
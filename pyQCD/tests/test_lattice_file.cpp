@@ -0,0 +1,74 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstdio>
+
+#include <Eigen/Dense>
+
+#include <io/lattice_file.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("Lattice file test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  MatrixCompare<Eigen::Matrix3cd> comparison(1.0e-12, 1.0e-15);
+
+  SECTION("Test write/map round trip") {
+    pyQCD::Lattice<double> lattice(layout, 0.0);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      lattice[i] = 3.0 * i;
+    }
+    pyQCD::write_lattice(lattice, "test_lattice_file.bin");
+
+    pyQCD::MappedLattice<double> mapped("test_lattice_file.bin");
+    REQUIRE(mapped.num_dims() == 4);
+    REQUIRE(mapped.shape() == layout.shape());
+    REQUIRE(mapped.volume() == layout.volume());
+    REQUIRE(mapped.layout_tag() == 0);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(mapped[i] == 3.0 * i);
+    }
+    std::remove("test_lattice_file.bin");
+  }
+
+  SECTION("Test element size check") {
+    pyQCD::Lattice<double> lattice(layout, 1.0);
+    pyQCD::write_lattice(lattice, "test_lattice_file.bin");
+    REQUIRE_THROWS(pyQCD::MappedLattice<float>("test_lattice_file.bin"));
+    std::remove("test_lattice_file.bin");
+  }
+
+  SECTION("Test raw gauge field import") {
+    // Build a synthetic big-endian payload with known link values
+    typedef pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+      GaugeField;
+    std::vector<GaugeField> expected(4, GaugeField(layout));
+    std::ofstream file("test_gauge_import.bin", std::ios::binary);
+    for (unsigned int site_index = 0;
+         site_index < layout.volume();
+         ++site_index) {
+      for (unsigned int mu = 0; mu < 4; ++mu) {
+        Eigen::Matrix3cd link = Eigen::Matrix3cd::Random();
+        expected[mu][layout.get_array_index(site_index)] = link;
+        for (unsigned int row = 0; row < 3; ++row) {
+          for (unsigned int col = 0; col < 3; ++col) {
+            double swapped[2]
+              = {pyQCD::detail::swap_endian(link(row, col).real()),
+                 pyQCD::detail::swap_endian(link(row, col).imag())};
+            file.write(reinterpret_cast<const char*>(swapped),
+                       sizeof(swapped));
+          }
+        }
+      }
+    }
+    file.close();
+
+    std::vector<GaugeField> imported(4, GaugeField(layout));
+    pyQCD::import_raw_gauge_field("test_gauge_import.bin", imported);
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      for (unsigned int i = 0; i < layout.volume(); ++i) {
+        REQUIRE(comparison(imported[mu][i], expected[mu][i]));
+      }
+    }
+    std::remove("test_gauge_import.bin");
+  }
+}
@@ -0,0 +1,55 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/lattice_soa.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::LatticeSoA<3, 3> LatticeSoA;
+typedef pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator> Lattice;
+
+TEST_CASE("LatticeSoA test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{8, 4, 4, 4});
+  MatrixCompare<Eigen::Matrix3cd> comparison(1.0e-8, 1.0e-12);
+
+  Lattice lattice1(layout, Eigen::Matrix3cd::Random());
+  Lattice lattice2(layout, Eigen::Matrix3cd::Random());
+
+  SECTION("Test round trip through Lattice") {
+    LatticeSoA soa(lattice1);
+    REQUIRE(soa.volume() == lattice1.volume());
+    REQUIRE(soa.layout() == lattice1.layout());
+    Lattice round_trip = soa.to_lattice();
+    for (unsigned int i = 0; i < lattice1.volume(); ++i) {
+      REQUIRE(comparison(round_trip[i], lattice1[i]));
+    }
+  }
+
+  SECTION("Test element accessors") {
+    LatticeSoA soa(layout);
+    Eigen::Matrix3cd mat = Eigen::Matrix3cd::Random();
+    soa.set(42, mat);
+    REQUIRE(comparison(soa[42], mat));
+  }
+
+  SECTION("Test batched multiply") {
+    LatticeSoA soa1(lattice1);
+    LatticeSoA soa2(lattice2);
+    LatticeSoA result(layout);
+    pyQCD::multiply(soa1, soa2, result);
+    for (unsigned int i = 0; i < lattice1.volume(); ++i) {
+      Eigen::Matrix3cd expected = lattice1[i] * lattice2[i];
+      REQUIRE(comparison(result[i], expected));
+    }
+  }
+
+  SECTION("Test batched add") {
+    LatticeSoA soa1(lattice1);
+    LatticeSoA soa2(lattice2);
+    LatticeSoA result(layout);
+    pyQCD::add(soa1, soa2, result);
+    for (unsigned int i = 0; i < lattice1.volume(); ++i) {
+      Eigen::Matrix3cd expected = lattice1[i] + lattice2[i];
+      REQUIRE(comparison(result[i], expected));
+    }
+  }
+}
@@ -0,0 +1,103 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/lattice_view.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("LatticeView test") {
+  const std::vector<unsigned int> shape{8, 4, 4, 4};
+  pyQCD::LexicoLayout layout(shape);
+  pyQCD::Lattice<double> lattice(layout, 0.0);
+  // Encode the time coordinate in the site value so slicing is checkable
+  for (unsigned int i = 0; i < layout.volume(); ++i) {
+    lattice[i] = static_cast<double>(layout.get_site_index(i) / (4 * 4 * 4));
+  }
+
+  SECTION ("Testing timeslice site selection") {
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      auto view = pyQCD::timeslice(lattice, t);
+      REQUIRE (view.size() == layout.volume() / shape[0]);
+      for (unsigned long i = 0; i < view.size(); ++i) {
+        REQUIRE (view[i] == static_cast<double>(t));
+      }
+    }
+  }
+
+  SECTION ("Testing timeslice reduction without copying") {
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      REQUIRE (pyQCD::sum(pyQCD::timeslice(lattice, t))
+               == t * (layout.volume() / shape[0]));
+    }
+  }
+
+  SECTION ("Testing views as expression operands") {
+    auto view0 = pyQCD::timeslice(lattice, 2);
+    auto view1 = pyQCD::timeslice(lattice, 5);
+    REQUIRE (pyQCD::sum(view0 + view1) == 7.0 * view0.size());
+    REQUIRE (pyQCD::sum(2.0 * view1) == 10.0 * view1.size());
+    REQUIRE (pyQCD::dot(view0, view1) == 10.0 * view0.size());
+  }
+
+  SECTION ("Testing writes through a view") {
+    auto view = pyQCD::timeslice(lattice, 3);
+    view = 100.0;
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      const unsigned int t = layout.get_site_index(i) / (4 * 4 * 4);
+      REQUIRE (lattice[i] == (t == 3 ? 100.0 : static_cast<double>(t)));
+    }
+    // Expression assignment into a view
+    auto src = pyQCD::timeslice(lattice, 5);
+    view = 2.0 * src;
+    for (unsigned long i = 0; i < view.size(); ++i) {
+      REQUIRE (view[i] == 10.0);
+    }
+  }
+
+  SECTION ("Testing sublattice view") {
+    pyQCD::Lattice<double> lexico(layout, 0.0);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      lexico[i] = static_cast<double>(layout.get_site_index(i));
+    }
+    const std::vector<unsigned int> corner{1, 2, 0, 3};
+    const std::vector<unsigned int> block_shape{2, 2, 2, 2};
+    auto view = pyQCD::sublattice(lexico, corner, block_shape);
+    REQUIRE (view.size() == 16);
+    unsigned long view_index = 0;
+    for (unsigned int t = 0; t < 2; ++t) {
+      for (unsigned int x = 0; x < 2; ++x) {
+        for (unsigned int y = 0; y < 2; ++y) {
+          for (unsigned int z = 0; z < 2; ++z) {
+            const std::vector<unsigned int> site{
+              (corner[0] + t) % shape[0], (corner[1] + x) % shape[1],
+              (corner[2] + y) % shape[2], (corner[3] + z) % shape[3]};
+            unsigned int site_index = 0;
+            for (unsigned int d = 0; d < 4; ++d) {
+              site_index = site_index * shape[d] + site[d];
+            }
+            REQUIRE (view[view_index++] == static_cast<double>(site_index));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION ("Testing views on a non-trivial layout") {
+    // Index lists go through Layout::get_array_index, so slicing an even-odd
+    // field selects the same physical sites as slicing a lexicographic one
+    pyQCD::EvenOddLayout eo_layout(shape);
+    pyQCD::Lattice<double> eo_lattice(eo_layout, 0.0);
+    for (unsigned int i = 0; i < eo_layout.volume(); ++i) {
+      eo_lattice[i]
+        = static_cast<double>(eo_layout.get_site_index(i) / (4 * 4 * 4));
+    }
+    for (unsigned int t = 0; t < shape[0]; ++t) {
+      REQUIRE (pyQCD::sum(pyQCD::timeslice(eo_lattice, t))
+               == t * (eo_layout.volume() / shape[0]));
+    }
+  }
+
+  SECTION ("Testing bounds checks") {
+    REQUIRE_THROWS (pyQCD::timeslice(lattice, shape[0]));
+    REQUIRE_THROWS (pyQCD::sublattice(lattice, {0, 0}, {2, 2}));
+  }
+}
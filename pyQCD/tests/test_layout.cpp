@@ -17,3 +17,209 @@ TEST_CASE("LexicoLayout test") {
   REQUIRE (layout.volume() == 512);
   REQUIRE (layout.num_dims() == 4);
 }
+
+TEST_CASE("StaticLexicoLayout test") {
+  pyQCD::StaticLexicoLayout layout(std::vector<unsigned int>{8, 4, 4, 4});
+
+  for (int i = 0; i < 512; ++i) {
+    REQUIRE (layout.get_array_index(i) == i);
+    REQUIRE (layout.get_site_index(i) == i);
+  }
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{4, 3, 2, 1})
+             == 313);
+  REQUIRE (layout.volume() == 512);
+  REQUIRE (layout.num_dims() == 4);
+
+  // The neighbour table must still exist and agree with LexicoLayout's
+  pyQCD::LexicoLayout dynamic_layout(std::vector<unsigned int>{8, 4, 4, 4});
+  for (unsigned int i = 0; i < 512; ++i) {
+    for (unsigned int d = 0; d < 4; ++d) {
+      for (unsigned int direction = 0; direction < 2; ++direction) {
+        REQUIRE (layout.get_neighbour_index(i, d, direction)
+                   == dynamic_layout.get_neighbour_index(i, d, direction));
+      }
+    }
+  }
+}
+
+TEST_CASE("FixedLexicoLayout test") {
+  pyQCD::FixedLexicoLayout<4> layout(std::vector<unsigned int>{8, 4, 4, 4});
+  pyQCD::LexicoLayout dynamic_layout(std::vector<unsigned int>{8, 4, 4, 4});
+
+  REQUIRE (layout.volume() == 512);
+  REQUIRE (layout.num_dims() == 4);
+  REQUIRE_THROWS (pyQCD::FixedLexicoLayout<3>(
+    std::vector<unsigned int>{8, 4, 4, 4}));
+
+  for (unsigned int i = 0; i < 512; ++i) {
+    REQUIRE (layout.get_array_index(i) == i);
+    REQUIRE (layout.get_site_index(i) == i);
+  }
+  // Coordinate indexing agrees with the dynamic layout at every site
+  for (unsigned int t = 0; t < 8; ++t) {
+    for (unsigned int x = 0; x < 4; ++x) {
+      for (unsigned int y = 0; y < 4; ++y) {
+        for (unsigned int z = 0; z < 4; ++z) {
+          const std::vector<unsigned int> site{t, x, y, z};
+          REQUIRE (layout.get_array_index(site)
+                     == dynamic_layout.get_array_index(site));
+        }
+      }
+    }
+  }
+  for (unsigned int i = 0; i < 512; ++i) {
+    for (unsigned int d = 0; d < 4; ++d) {
+      for (unsigned int direction = 0; direction < 2; ++direction) {
+        REQUIRE (layout.get_neighbour_index(i, d, direction)
+                   == dynamic_layout.get_neighbour_index(i, d, direction));
+      }
+    }
+  }
+}
+
+TEST_CASE("ConstShapeLexicoLayout test") {
+  pyQCD::ConstShapeLexicoLayout<8, 4, 4, 4> layout;
+  pyQCD::LexicoLayout dynamic_layout(std::vector<unsigned int>{8, 4, 4, 4});
+
+  static_assert(pyQCD::ConstShapeLexicoLayout<8, 4, 4, 4>::static_volume
+                  == 512,
+                "static_volume != 512");
+  REQUIRE (layout.volume() == 512);
+  REQUIRE (layout.num_dims() == 4);
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{4, 3, 2, 1})
+             == 313);
+
+  for (unsigned int t = 0; t < 8; ++t) {
+    for (unsigned int x = 0; x < 4; ++x) {
+      for (unsigned int y = 0; y < 4; ++y) {
+        for (unsigned int z = 0; z < 4; ++z) {
+          const std::vector<unsigned int> site{t, x, y, z};
+          REQUIRE (layout.get_array_index(site)
+                     == dynamic_layout.get_array_index(site));
+        }
+      }
+    }
+  }
+  for (unsigned int i = 0; i < 512; ++i) {
+    for (unsigned int d = 0; d < 4; ++d) {
+      for (unsigned int direction = 0; direction < 2; ++direction) {
+        REQUIRE (layout.get_neighbour_index(i, d, direction)
+                   == dynamic_layout.get_neighbour_index(i, d, direction));
+      }
+    }
+  }
+}
+
+TEST_CASE("EvenOddLayout test") {
+  std::vector<unsigned int> shape{8, 4, 4, 4};
+  pyQCD::EvenOddLayout layout(shape);
+
+  REQUIRE (layout.volume() == 512);
+  REQUIRE (layout.num_dims() == 4);
+
+  // The layout must be a bijection between site and array indices
+  std::vector<unsigned int> counts(512, 0);
+  for (unsigned int i = 0; i < 512; ++i) {
+    counts[layout.get_array_index(i)]++;
+    REQUIRE (layout.get_site_index(layout.get_array_index(i)) == i);
+  }
+  for (unsigned int i = 0; i < 512; ++i) {
+    REQUIRE (counts[i] == 1);
+  }
+
+  // Even sites must fill the first half of the array, odd sites the second,
+  // each half in lexicographic order
+  unsigned int prev_even = 0, prev_odd = 0;
+  for (unsigned int i = 0; i < 512; ++i) {
+    unsigned int parity = 0, remainder = i;
+    for (unsigned int j = shape.size(); j-- > 0;) {
+      parity += remainder % shape[j];
+      remainder /= shape[j];
+    }
+    unsigned int array_index = layout.get_array_index(i);
+    if (parity % 2 == 0) {
+      REQUIRE (array_index < 256);
+      REQUIRE ((i == 0 or array_index > prev_even));
+      prev_even = array_index;
+    }
+    else {
+      REQUIRE (array_index >= 256);
+      REQUIRE ((prev_odd == 0 or array_index > prev_odd));
+      prev_odd = array_index;
+    }
+  }
+
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{0, 0, 0, 0}) == 0);
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{0, 0, 0, 1})
+             == 256);
+}
+
+TEST_CASE("TiledLayout test") {
+  std::vector<unsigned int> shape{8, 4, 4, 4};
+  std::vector<unsigned int> tile_shape{2, 2, 2, 2};
+  pyQCD::TiledLayout layout(shape, tile_shape);
+
+  REQUIRE (layout.volume() == 512);
+  REQUIRE (layout.num_dims() == 4);
+
+  // The layout must be a bijection between site and array indices
+  std::vector<unsigned int> counts(512, 0);
+  for (unsigned int i = 0; i < 512; ++i) {
+    counts[layout.get_array_index(i)]++;
+    REQUIRE (layout.get_site_index(layout.get_array_index(i)) == i);
+  }
+  for (unsigned int i = 0; i < 512; ++i) {
+    REQUIRE (counts[i] == 1);
+  }
+
+  // Each tile's sites must be contiguous: the first tile holds the 2^4
+  // sites with all coordinates < 2, in lexicographic order
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{0, 0, 0, 0}) == 0);
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{0, 0, 0, 1}) == 1);
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{0, 0, 1, 0}) == 2);
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{1, 1, 1, 1})
+             == 15);
+  // ...and the next tile along the last dimension follows it
+  REQUIRE (layout.get_array_index(std::vector<unsigned int>{0, 0, 0, 2})
+             == 16);
+
+  REQUIRE_THROWS (pyQCD::TiledLayout(shape,
+    std::vector<unsigned int>{3, 2, 2, 2}));
+}
+
+TEST_CASE("Neighbour table test") {
+  std::vector<unsigned int> shape{8, 4, 4, 4};
+  pyQCD::LexicoLayout lexico_layout(shape);
+  pyQCD::EvenOddLayout even_odd_layout(shape);
+  pyQCD::TiledLayout tiled_layout(shape,
+                                  std::vector<unsigned int>{2, 2, 2, 2});
+
+  REQUIRE (lexico_layout.get_neighbour_index(0, 3, 0) == 1);
+  REQUIRE (lexico_layout.get_neighbour_index(0, 3, 1) == 3);
+  REQUIRE (lexico_layout.get_neighbour_index(0, 0, 0) == 64);
+  REQUIRE (lexico_layout.get_neighbour_index(0, 0, 1) == 448);
+
+  // The table must agree with coordinate-based lookup for any layout
+  std::vector<pyQCD::Layout*> layouts{&lexico_layout, &even_odd_layout,
+                                      &tiled_layout};
+  for (auto layout : layouts) {
+    for (unsigned int i = 0; i < layout->volume(); ++i) {
+      std::vector<unsigned int> site(4);
+      unsigned int remainder = i;
+      for (unsigned int d = 4; d-- > 0;) {
+        site[d] = remainder % shape[d];
+        remainder /= shape[d];
+      }
+      unsigned int array_index = layout->get_array_index(i);
+      for (unsigned int d = 0; d < 4; ++d) {
+        for (unsigned int direction = 0; direction < 2; ++direction) {
+          std::vector<unsigned int> neighbour = site;
+          neighbour[d] = (site[d] + shape[d] + (direction == 0 ? 1 : -1))
+            % shape[d];
+          REQUIRE (layout->get_neighbour_index(array_index, d, direction)
+                     == layout->get_array_index(neighbour));
+        }
+      }
+    }
+  }
+}
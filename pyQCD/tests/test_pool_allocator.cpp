@@ -0,0 +1,41 @@
+#define CATCH_CONFIG_MAIN
+
+#include <core/lattice.hpp>
+#include <utils/pool_allocator.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("MemoryPool test") {
+  pyQCD::MemoryPool& pool = pyQCD::MemoryPool::instance();
+
+  SECTION("Test block reuse") {
+    void* first = pool.allocate(1000000);
+    pool.deallocate(first, 1000000);
+    // A freed block must be handed straight back for a same-bucket request
+    void* second = pool.allocate(1000000);
+    REQUIRE(second == first);
+    pool.deallocate(second, 1000000);
+  }
+
+  SECTION("Test alignment") {
+    for (unsigned int i = 1; i < 100; i += 7) {
+      void* ptr = pool.allocate(i * 48);
+      bool aligned = reinterpret_cast<std::uintptr_t>(ptr)
+        % pyQCD::MemoryPool::alignment == 0;
+      REQUIRE(aligned);
+      pool.deallocate(ptr, i * 48);
+    }
+    pool.release_cached_blocks();
+  }
+}
+
+TEST_CASE("PoolAllocator test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{8, 4, 4, 4});
+  pyQCD::Lattice<double, pyQCD::PoolAllocator> lattice1(layout, 1.0);
+  pyQCD::Lattice<double, pyQCD::PoolAllocator> lattice2(layout, 2.0);
+
+  decltype(lattice1) lattice3 = lattice1 + lattice2;
+  for (auto val : lattice3) {
+    REQUIRE(val == 3.0);
+  }
+}
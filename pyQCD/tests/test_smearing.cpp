@@ -0,0 +1,70 @@
+#define CATCH_CONFIG_MAIN
+
+#include <gauge/smearing.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::Lattice<Eigen::Matrix3cd, Eigen::aligned_allocator>
+  GaugeField;
+
+TEST_CASE("Smearing test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  MatrixCompare<Eigen::Matrix3cd> comparison(1.0e-8, 1.0e-11);
+
+  std::vector<GaugeField> unit_field(
+    4, GaugeField(layout, Eigen::Matrix3cd::Identity()));
+
+  std::vector<GaugeField> random_field(
+    4, GaugeField(layout, Eigen::Matrix3cd::Identity()));
+  for (unsigned int mu = 0; mu < 4; ++mu) {
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      random_field[mu][i]
+        = pyQCD::project_su3<double>(Eigen::Matrix3cd::Random());
+    }
+  }
+
+  SECTION("Test SU(3) projection") {
+    for (unsigned int i = 0; i < layout.volume(); i += 19) {
+      const Eigen::Matrix3cd& link = random_field[0][i];
+      REQUIRE((link * link.adjoint() - Eigen::Matrix3cd::Identity()).norm()
+                < 1.0e-10);
+      REQUIRE(std::abs(link.determinant() - 1.0) < 1.0e-10);
+    }
+  }
+
+  SECTION("Test unit gauge field is a fixed point") {
+    std::vector<GaugeField> smeared = unit_field;
+    pyQCD::ape_smear(smeared, 3, 0.5);
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      for (unsigned int i = 0; i < layout.volume(); i += 19) {
+        REQUIRE(comparison(smeared[mu][i], Eigen::Matrix3cd::Identity()));
+      }
+    }
+    smeared = unit_field;
+    pyQCD::stout_smear(smeared, 3, 0.1);
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      for (unsigned int i = 0; i < layout.volume(); i += 19) {
+        REQUIRE(comparison(smeared[mu][i], Eigen::Matrix3cd::Identity()));
+      }
+    }
+  }
+
+  SECTION("Test smearing stays in SU(3)") {
+    std::vector<GaugeField> ape_smeared = random_field;
+    pyQCD::ape_smear(ape_smeared, 2, 0.5);
+    std::vector<GaugeField> stout_smeared = random_field;
+    pyQCD::stout_smear(stout_smeared, 2, 0.1);
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      for (unsigned int i = 0; i < layout.volume(); i += 19) {
+        for (const Eigen::Matrix3cd& link
+               : {ape_smeared[mu][i], stout_smeared[mu][i]}) {
+          REQUIRE((link * link.adjoint()
+                   - Eigen::Matrix3cd::Identity()).norm() < 1.0e-10);
+          REQUIRE(std::abs(link.determinant() - 1.0) < 1.0e-10);
+        }
+        // Smearing must actually change the links
+        REQUIRE(!comparison(stout_smeared[mu][i], random_field[mu][i]));
+      }
+    }
+  }
+}
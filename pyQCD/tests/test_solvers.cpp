@@ -0,0 +1,89 @@
+#define CATCH_CONFIG_MAIN
+
+#include <algorithms/solvers.hpp>
+#include <fermions/wilson_dirac.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::WilsonDiracOperator<double> Dirac;
+
+// Hermitian positive-definite diagonal operator for exercising CG
+struct DiagonalOperator
+{
+  void apply(Dirac::FermionField& out, const Dirac::FermionField& in) const
+  {
+    for (unsigned long i = 0; i < out.size(); ++i) {
+      for (unsigned long alpha = 0; alpha < out[i].size(); ++alpha) {
+        out[i][alpha] = (2.0 + i % 3) * in[i][alpha];
+      }
+    }
+  }
+};
+
+TEST_CASE("Solver test") {
+  pyQCD::EvenOddLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  MatrixCompare<Dirac::ColourVector> comparison(1.0e-6, 1.0e-8);
+
+  Dirac::SiteFermion zero_fermion(Dirac::num_spins,
+                                  Dirac::ColourVector::Zero());
+  Dirac::FermionField rhs(layout, zero_fermion);
+  for (unsigned int i = 0; i < layout.volume(); ++i) {
+    for (unsigned int alpha = 0; alpha < Dirac::num_spins; ++alpha) {
+      rhs[i][alpha] = Dirac::ColourVector::Random();
+    }
+  }
+
+  std::vector<Dirac::GaugeField> gauge_field(
+    4, Dirac::GaugeField(layout, Dirac::ColourMatrix::Identity()));
+
+  SECTION("Test conjugate gradient") {
+    DiagonalOperator op;
+    Dirac::FermionField solution(layout, zero_fermion);
+    auto results
+      = pyQCD::conjugate_gradient(op, rhs, solution, 100, 1.0e-10);
+    REQUIRE(results.final_residual < 1.0e-10);
+    REQUIRE(results.iterations <= 100);
+    REQUIRE(results.residuals.size() == results.iterations);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      for (unsigned int alpha = 0; alpha < Dirac::num_spins; ++alpha) {
+        Dirac::ColourVector expected = rhs[i][alpha] / (2.0 + i % 3);
+        REQUIRE(comparison(solution[i][alpha], expected));
+      }
+    }
+  }
+
+  SECTION("Test BiCGstab on the Wilson operator") {
+    Dirac dirac_op(0.4, gauge_field);
+    Dirac::FermionField solution(layout, zero_fermion);
+    auto results = pyQCD::bicgstab(dirac_op, rhs, solution, 100, 1.0e-10);
+    REQUIRE(results.final_residual < 1.0e-10);
+    // Verify the solution by applying the operator
+    Dirac::FermionField check(layout, zero_fermion);
+    dirac_op.apply(check, solution);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      for (unsigned int alpha = 0; alpha < Dirac::num_spins; ++alpha) {
+        REQUIRE(comparison(check[i][alpha], rhs[i][alpha]));
+      }
+    }
+  }
+
+  SECTION("Test even-odd preconditioned solve") {
+    const double mass = 0.4;
+    pyQCD::EvenOddPreconditionedWilson<double> schur_op(mass, gauge_field);
+    Dirac::FermionField reduced_rhs = schur_op.prepare_source(rhs);
+    Dirac::FermionField solution(layout, zero_fermion);
+    auto results
+      = pyQCD::bicgstab(schur_op, reduced_rhs, solution, 100, 1.0e-10);
+    REQUIRE(results.final_residual < 1.0e-10);
+    schur_op.reconstruct(solution, rhs);
+    // The reconstructed full solution must solve the unpreconditioned system
+    Dirac dirac_op(mass, gauge_field);
+    Dirac::FermionField check(layout, zero_fermion);
+    dirac_op.apply(check, solution);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      for (unsigned int alpha = 0; alpha < Dirac::num_spins; ++alpha) {
+        REQUIRE(comparison(check[i][alpha], rhs[i][alpha]));
+      }
+    }
+  }
+}
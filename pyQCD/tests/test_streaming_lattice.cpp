@@ -0,0 +1,87 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstdio>
+
+#include <io/streaming_lattice.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("StreamingLattice test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  // A chunk size that does not divide the volume, so the final chunk is short
+  const unsigned int chunk_volume = 100;
+
+  SECTION("Test chunked sweep with write-back") {
+    pyQCD::StreamingLattice<double> streamed(
+      "test_streaming_lattice.bin", layout, chunk_volume);
+    REQUIRE(streamed.volume() == layout.volume());
+    REQUIRE(streamed.num_chunks() == 3);
+
+    // First sweep initializes each site from its global array index
+    streamed.sweep([] (pyQCD::Array<double>& chunk,
+                       const unsigned long begin) {
+      for (unsigned long i = 0; i < chunk.size(); ++i) {
+        chunk[i] = 2.0 * (begin + i);
+      }
+    });
+    // Second sweep updates chunks through the expression templates
+    streamed.sweep([] (pyQCD::Array<double>& chunk, const unsigned long) {
+      chunk = chunk * 3.0 + pyQCD::Array<double>(chunk.size(), 1.0);
+    });
+    // Read-only sweep sees the accumulated result in array order
+    const pyQCD::StreamingLattice<double>& const_streamed = streamed;
+    unsigned long num_sites = 0;
+    const_streamed.sweep([&num_sites] (const pyQCD::Array<double>& chunk,
+                                       const unsigned long begin) {
+      for (unsigned long i = 0; i < chunk.size(); ++i) {
+        REQUIRE(chunk[i] == 6.0 * (begin + i) + 1.0);
+      }
+      num_sites += chunk.size();
+    });
+    REQUIRE(num_sites == layout.volume());
+    std::remove("test_streaming_lattice.bin");
+  }
+
+  SECTION("Test file interoperability and reopening") {
+    {
+      pyQCD::StreamingLattice<double> streamed(
+        "test_streaming_lattice.bin", layout, chunk_volume);
+      streamed.sweep([] (pyQCD::Array<double>& chunk,
+                         const unsigned long begin) {
+        for (unsigned long i = 0; i < chunk.size(); ++i) {
+          chunk[i] = 1.5 * (begin + i);
+        }
+      });
+    }
+    // The on-disk format is the lattice-file format, so MappedLattice can
+    // open what a StreamingLattice wrote
+    pyQCD::MappedLattice<double> mapped("test_streaming_lattice.bin");
+    REQUIRE(mapped.shape() == layout.shape());
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      REQUIRE(mapped[i] == 1.5 * i);
+    }
+    // Reopening resumes against the existing payload
+    pyQCD::StreamingLattice<double> reopened(
+      "test_streaming_lattice.bin", layout, chunk_volume);
+    reopened.sweep([] (const pyQCD::Array<double>& chunk,
+                       const unsigned long begin) {
+      for (unsigned long i = 0; i < chunk.size(); ++i) {
+        REQUIRE(chunk[i] == 1.5 * (begin + i));
+      }
+    });
+    std::remove("test_streaming_lattice.bin");
+  }
+
+  SECTION("Test geometry check on open") {
+    {
+      pyQCD::StreamingLattice<double> streamed(
+        "test_streaming_lattice.bin", layout, chunk_volume);
+    }
+    pyQCD::LexicoLayout other_layout(std::vector<unsigned int>{8, 4, 4, 4});
+    REQUIRE_THROWS(pyQCD::StreamingLattice<double>(
+      "test_streaming_lattice.bin", other_layout, chunk_volume));
+    REQUIRE_THROWS(pyQCD::StreamingLattice<float>(
+      "test_streaming_lattice.bin", layout, chunk_volume));
+    std::remove("test_streaming_lattice.bin");
+  }
+}
@@ -0,0 +1,75 @@
+#define CATCH_CONFIG_MAIN
+
+#include <atomic>
+
+#include <utils/thread_pool.hpp>
+
+#include "helpers.hpp"
+
+TEST_CASE("ThreadPool test") {
+  pyQCD::ThreadPool& pool = pyQCD::ThreadPool::instance();
+  REQUIRE (pool.num_threads() >= 1);
+
+  SECTION ("Testing parallel_for index coverage") {
+    const unsigned long n = 16 * PYQCD_PARALLEL_THRESHOLD;
+    std::vector<int> counts(n, 0);
+    pyQCD::parallel_for(n, [&counts] (const unsigned long i)
+      { counts[i]++; });
+    // Every index visited exactly once
+    for (unsigned long i = 0; i < n; ++i) {
+      REQUIRE (counts[i] == 1);
+    }
+  }
+
+  SECTION ("Testing for_blocks partition") {
+    const unsigned long begin = 7, end = 4 * PYQCD_PARALLEL_THRESHOLD;
+    std::atomic<unsigned long> total(0);
+    std::atomic<unsigned int> num_blocks(0);
+    pool.for_blocks(begin, end,
+      [&total, &num_blocks] (const unsigned long block_begin,
+                             const unsigned long block_end) {
+        unsigned long sum = 0;
+        for (unsigned long i = block_begin; i < block_end; ++i) {
+          sum += i;
+        }
+        total += sum;
+        num_blocks++;
+      });
+    REQUIRE (total == (end * (end - 1) - begin * (begin - 1)) / 2);
+    REQUIRE (num_blocks <= pool.num_threads());
+  }
+
+  SECTION ("Testing repeated dispatch") {
+    // Thousands of launches, the granularity of a Krylov solve
+    const unsigned long n = 2 * PYQCD_PARALLEL_THRESHOLD;
+    std::vector<double> data(n, 0.0);
+    for (unsigned int iteration = 0; iteration < 1000; ++iteration) {
+      double* ptr = &data[0];
+      pyQCD::parallel_for(n, [ptr] (const unsigned long i)
+        { ptr[i] += 1.0; });
+    }
+    for (unsigned long i = 0; i < n; ++i) {
+      REQUIRE (data[i] == 1000.0);
+    }
+  }
+
+  SECTION ("Testing nested submission") {
+    // A parallel_for from inside a worker must run serially, not deadlock
+    const unsigned long n = 4 * PYQCD_PARALLEL_THRESHOLD;
+    std::atomic<unsigned long> total(0);
+    pyQCD::parallel_for(n, [&total, n] (const unsigned long i) {
+      if (i == 0) {
+        pyQCD::parallel_for(n, [&total] (const unsigned long) { total++; });
+      }
+    });
+    REQUIRE (total == n);
+  }
+
+  SECTION ("Testing empty and small ranges") {
+    pool.for_blocks(10, 10, [] (const unsigned long, const unsigned long)
+      { REQUIRE (false); });
+    std::vector<int> counts(3, 0);
+    pyQCD::parallel_for(3, [&counts] (const unsigned long i) { counts[i]++; });
+    REQUIRE (counts == std::vector<int>(3, 1));
+  }
+}
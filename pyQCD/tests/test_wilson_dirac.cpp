@@ -0,0 +1,78 @@
+#define CATCH_CONFIG_MAIN
+
+#include <fermions/wilson_dirac.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::WilsonDiracOperator<double> Dirac;
+
+TEST_CASE("Wilson Dirac operator test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+  MatrixCompare<Dirac::ColourVector> comparison(1.0e-10, 1.0e-13);
+
+  std::vector<Dirac::GaugeField> gauge_field;
+  for (unsigned int mu = 0; mu < 4; ++mu) {
+    gauge_field.push_back(Dirac::GaugeField(layout));
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      gauge_field[mu][i] = Dirac::ColourMatrix::Random();
+    }
+  }
+
+  Dirac::SiteFermion zero_fermion(Dirac::num_spins,
+                                  Dirac::ColourVector::Zero());
+  Dirac::FermionField fermion_in(layout, zero_fermion);
+  Dirac::FermionField fermion_out(layout, zero_fermion);
+  for (unsigned int i = 0; i < layout.volume(); ++i) {
+    for (unsigned int alpha = 0; alpha < Dirac::num_spins; ++alpha) {
+      fermion_in[i][alpha] = Dirac::ColourVector::Random();
+    }
+  }
+
+  SECTION("Test gamma matrices") {
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      // Hermitian and squaring to the identity
+      REQUIRE((Dirac::gamma(mu) - Dirac::gamma(mu).adjoint()).norm()
+                < 1.0e-14);
+      REQUIRE((Dirac::gamma(mu) * Dirac::gamma(mu)
+               - Dirac::SpinMatrix::Identity()).norm() < 1.0e-14);
+      // Anticommuting with the others
+      for (unsigned int nu = 0; nu < mu; ++nu) {
+        REQUIRE((Dirac::gamma(mu) * Dirac::gamma(nu)
+                 + Dirac::gamma(nu) * Dirac::gamma(mu)).norm() < 1.0e-14);
+      }
+    }
+  }
+
+  SECTION("Test apply against naive per-site evaluation") {
+    const double mass = 0.1;
+    Dirac dirac_op(mass, gauge_field);
+    dirac_op.apply(fermion_out, fermion_in);
+
+    std::vector<unsigned int> shape{4, 4, 4, 4};
+    for (unsigned int i = 0; i < layout.volume(); i += 37) {
+      std::vector<unsigned int> site(4);
+      unsigned int site_index = layout.get_site_index(i);
+      for (unsigned int d = 4; d-- > 0;) {
+        site[d] = site_index % shape[d];
+        site_index /= shape[d];
+      }
+      for (unsigned int alpha = 0; alpha < Dirac::num_spins; ++alpha) {
+        Dirac::ColourVector expected
+          = (4 + mass) * fermion_in(site)[alpha];
+        for (unsigned int mu = 0; mu < 4; ++mu) {
+          std::vector<unsigned int> fwd = site, bwd = site;
+          fwd[mu] = (site[mu] + 1) % shape[mu];
+          bwd[mu] = (site[mu] + shape[mu] - 1) % shape[mu];
+          for (unsigned int beta = 0; beta < Dirac::num_spins; ++beta) {
+            Dirac::Complex delta = (alpha == beta) ? 1.0 : 0.0;
+            expected -= 0.5 * (delta - Dirac::gamma(mu)(alpha, beta))
+              * (gauge_field[mu](site) * fermion_in(fwd)[beta]);
+            expected -= 0.5 * (delta + Dirac::gamma(mu)(alpha, beta))
+              * (gauge_field[mu](bwd).adjoint() * fermion_in(bwd)[beta]);
+          }
+        }
+        REQUIRE(comparison(fermion_out(site)[alpha], expected));
+      }
+    }
+  }
+}
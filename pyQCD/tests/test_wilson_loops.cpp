@@ -0,0 +1,81 @@
+#define CATCH_CONFIG_MAIN
+
+#include <gauge/smearing.hpp>
+#include <gauge/wilson_loops.hpp>
+
+#include "helpers.hpp"
+
+typedef pyQCD::WilsonLoopEngine<double> Engine;
+
+TEST_CASE("Wilson loop test") {
+  pyQCD::LexicoLayout layout(std::vector<unsigned int>{4, 4, 4, 4});
+
+  std::vector<Engine::GaugeField> unit_field(
+    4, Engine::GaugeField(layout, Engine::ColourMatrix::Identity()));
+
+  std::vector<Engine::GaugeField> random_field(
+    4, Engine::GaugeField(layout, Engine::ColourMatrix::Identity()));
+  for (unsigned int mu = 0; mu < 4; ++mu) {
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      random_field[mu][i]
+        = pyQCD::project_su3<double>(Engine::ColourMatrix::Random());
+    }
+  }
+
+  SECTION("Test unit gauge field") {
+    Engine engine(unit_field);
+    REQUIRE(std::abs(engine.average_plaquette() - 1.0) < 1.0e-12);
+    REQUIRE(std::abs(engine.average_wilson_loop(2, 3) - 1.0) < 1.0e-12);
+  }
+
+  SECTION("Test loop field against link-by-link traversal") {
+    Engine engine(random_field);
+    MatrixCompare<Engine::ColourMatrix> comparison(1.0e-9, 1.0e-12);
+    Engine::GaugeField loops = engine.loop_field(2, 1, 2, 3);
+    for (unsigned int i = 0; i < layout.volume(); i += 37) {
+      Engine::ColourMatrix expected = Engine::ColourMatrix::Identity();
+      unsigned int index = i;
+      for (unsigned int step = 0; step < 2; ++step) {
+        expected = expected * random_field[1][index];
+        index = layout.get_neighbour_index(index, 1, 0);
+      }
+      for (unsigned int step = 0; step < 2; ++step) {
+        expected = expected * random_field[3][index];
+        index = layout.get_neighbour_index(index, 3, 0);
+      }
+      for (unsigned int step = 0; step < 2; ++step) {
+        index = layout.get_neighbour_index(index, 1, 1);
+        expected = expected * random_field[1][index].adjoint();
+      }
+      for (unsigned int step = 0; step < 2; ++step) {
+        index = layout.get_neighbour_index(index, 3, 1);
+        expected = expected * random_field[3][index].adjoint();
+      }
+      REQUIRE(comparison(loops[i], expected));
+    }
+  }
+
+  SECTION("Test gauge invariance of the average plaquette") {
+    Engine engine(random_field);
+    const double plaquette = engine.average_plaquette();
+    REQUIRE(std::abs(plaquette) < 1.0);
+
+    // Gauge transform: U_mu(x) -> g(x) U_mu(x) g(x + mu)^dag
+    Engine::GaugeField transform(layout);
+    for (unsigned int i = 0; i < layout.volume(); ++i) {
+      transform[i]
+        = pyQCD::project_su3<double>(Engine::ColourMatrix::Random());
+    }
+    std::vector<Engine::GaugeField> transformed = random_field;
+    for (unsigned int mu = 0; mu < 4; ++mu) {
+      for (unsigned int i = 0; i < layout.volume(); ++i) {
+        unsigned int fwd = layout.get_neighbour_index(i, mu, 0);
+        transformed[mu][i]
+          = transform[i] * random_field[mu][i] * transform[fwd].adjoint();
+      }
+    }
+    Engine transformed_engine(transformed);
+    REQUIRE(std::abs(transformed_engine.average_plaquette() - plaquette)
+              < 1.0e-10);
+  }
+}
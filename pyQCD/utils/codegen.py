@@ -225,7 +225,8 @@ def write_core_template(template_fname, output_fname, output_path,
         f.write(template.render(**template_args))
 
 
-def generate_cython_types(output_path, precision, matrices):
+def generate_cython_types(output_path, precision, matrices, num_dims=4,
+                          static_shapes=()):
     """Generate Cython matrix, array and lattice types.
 
     This function gathers all jinja2 templates in the package templates
@@ -238,6 +239,10 @@ def generate_cython_types(output_path, precision, matrices):
         code (e.g. 'double' or 'float').
       matrices (iterable): An iterable object containing instances of
         MatrixDefinition.
+      num_dims (int): The number of lattice dimensions to emit a
+        fixed-dimension layout typedef for.
+      static_shapes (iterable): Optional lattice shapes (tuples of ints) to
+        emit compile-time-shape layout typedefs for.
     """
 
     # List of tuples of allowed binary operations
@@ -266,7 +271,8 @@ def generate_cython_types(output_path, precision, matrices):
         matrices, scalar_binary_ops + lattice_binary_ops, precision)
 
     write_core_template("types.hpp", "types.hpp", output_path,
-                        matrixdefs=matrices, precision=precision)
+                        matrixdefs=matrices, precision=precision,
+                        num_dims=num_dims, static_shapes=static_shapes)
     write_core_template("complex.pxd", "complex.pxd", output_path,
                         precision=precision)
     write_core_template("operators.pxd", "operators.pxd", output_path,
@@ -278,7 +284,8 @@ def generate_cython_types(output_path, precision, matrices):
                         precision=precision)
 
 
-def generate_qcd(num_colours, precision, representation, dest=None):
+def generate_qcd(num_colours, precision, representation, dest=None,
+                 num_dims=4, static_shapes=()):
     """Main script entry point
 
     Builds MatrixDefinition instances and passes them to generate_cython_types.
@@ -291,6 +298,10 @@ def generate_qcd(num_colours, precision, representation, dest=None):
         only 'fundamental' is supported.
       lib_dest (str): The root path in which to output the cython code.
         Defaults to the lib directory in the project root directory.
+      num_dims (int): The number of lattice dimensions to emit a
+        fixed-dimension layout typedef for.
+      static_shapes (iterable): Optional lattice shapes (tuples of ints) to
+        emit compile-time-shape layout typedefs for.
     """
 
     matrix_definitions = []
@@ -314,7 +325,8 @@ def generate_qcd(num_colours, precision, representation, dest=None):
         dest = src
 
     generate_cython_types(os.path.join(dest, "core"), precision,
-                          matrix_definitions)
+                          matrix_definitions, num_dims=num_dims,
+                          static_shapes=static_shapes)
 
 
 class CodeGen(setuptools.Command):
@@ -324,22 +336,36 @@ class CodeGen(setuptools.Command):
         ("num-colours=", "c", "Number of colours (defaults to 3)"),
         ("precision=", "p", "Fundamental type for real numbers "
                             "(defaults to double)"),
-        ("representation=", "r", "Representation (defaults to fundamental)")]
+        ("representation=", "r", "Representation (defaults to fundamental)"),
+        ("num-dims=", "d", "Number of lattice dimensions (defaults to 4)"),
+        ("static-shapes=", "s", "Comma-separated lattice shapes to emit "
+                                "compile-time layouts for, e.g. "
+                                "'32x32x32x64,24x24x24x48'")]
 
     def initialize_options(self):
         """Initialize options to their default values"""
         self.num_colours = 3
         self.precision = "double"
         self.representation = "fundamental"
+        self.num_dims = 4
+        self.static_shapes = ()
 
     def finalize_options(self):
-        """Finalize options - convert num_colours to int"""
+        """Finalize options - convert num_colours/num_dims/static_shapes"""
         if isinstance(self.num_colours, str):
             self.num_colours = int(self.num_colours)
+        if isinstance(self.num_dims, str):
+            self.num_dims = int(self.num_dims)
+        if isinstance(self.static_shapes, str):
+            self.static_shapes = tuple(
+                tuple(int(extent) for extent in shape.split('x'))
+                for shape in self.static_shapes.split(',') if shape)
 
     def run(self):
         """Run - pass execution to generate_qcd"""
-        generate_qcd(self.num_colours, self.precision, self.representation)
+        generate_qcd(self.num_colours, self.precision, self.representation,
+                     num_dims=self.num_dims,
+                     static_shapes=self.static_shapes)
 
 
 env.filters['to_underscores'] = _camel2underscores
@@ -0,0 +1,144 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+/* This file provides opt-in hot-path instrumentation, following the same
+ * compile-time switch pattern as pyQCDassert in utils/macros.hpp: with
+ * PYQCD_INSTRUMENT defined, PYQCD_SCOPED_KERNEL annotates a scope with a
+ * timer and byte/flop counters that accumulate per kernel name in a global
+ * registry, dumped to stderr at program exit (or on demand via report()).
+ * Without PYQCD_INSTRUMENT the macro expands to nothing, so annotated
+ * kernels carry no overhead in production builds.
+ */
+
+#ifdef PYQCD_INSTRUMENT
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+
+namespace pyQCD
+{
+  struct KernelCounters
+  {
+    unsigned long long num_calls;
+    double seconds;
+    unsigned long long bytes;
+    unsigned long long flops;
+  };
+
+
+  class InstrumentationRegistry
+  {
+    // Process-wide accumulator of per-kernel counters. Construction on
+    // first use; the at-exit report is registered then too, so merely
+    // including this header in an unannotated build prints nothing.
+  public:
+    static InstrumentationRegistry& instance()
+    {
+      static InstrumentationRegistry registry;
+      return registry;
+    }
+
+    void record(const std::string& name, const double seconds,
+                const unsigned long long bytes,
+                const unsigned long long flops)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      KernelCounters& counters = counters_[name];
+      counters.num_calls += 1;
+      counters.seconds += seconds;
+      counters.bytes += bytes;
+      counters.flops += flops;
+    }
+
+    KernelCounters query(const std::string& name)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return counters_[name];
+    }
+
+    void reset()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      counters_.clear();
+    }
+
+    void report(std::ostream& os)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (counters_.empty()) {
+        return;
+      }
+      os << "pyQCD instrumentation report:" << std::endl;
+      for (const auto& entry : counters_) {
+        const KernelCounters& counters = entry.second;
+        os << "  " << entry.first << ": " << counters.num_calls
+           << " calls, " << std::setprecision(6) << counters.seconds
+           << " s";
+        if (counters.bytes > 0 and counters.seconds > 0.0) {
+          os << ", " << counters.bytes / counters.seconds / 1.0e9 << " GB/s";
+        }
+        if (counters.flops > 0 and counters.seconds > 0.0) {
+          os << ", " << counters.flops / counters.seconds / 1.0e6
+             << " Mflops";
+        }
+        os << std::endl;
+      }
+    }
+
+  private:
+    InstrumentationRegistry()
+    { std::atexit(&InstrumentationRegistry::report_at_exit); }
+
+    static void report_at_exit() { instance().report(std::cerr); }
+
+    std::mutex mutex_;
+    std::map<std::string, KernelCounters> counters_;
+  };
+
+
+  class ScopedKernelTimer
+  {
+    // Times the enclosing scope and files the result, with the supplied
+    // traffic/work estimates, under the given kernel name.
+  public:
+    ScopedKernelTimer(const char* name, const unsigned long long bytes,
+                      const unsigned long long flops)
+      : name_(name), bytes_(bytes), flops_(flops),
+        start_(std::chrono::steady_clock::now())
+    { }
+
+    ~ScopedKernelTimer()
+    {
+      const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_).count();
+      InstrumentationRegistry::instance().record(name_, seconds, bytes_,
+                                                 flops_);
+    }
+
+  private:
+    const char* name_;
+    unsigned long long bytes_, flops_;
+    std::chrono::steady_clock::time_point start_;
+  };
+}
+
+#define PYQCD_INSTRUMENT_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define PYQCD_INSTRUMENT_CONCAT(lhs, rhs)                       \
+PYQCD_INSTRUMENT_CONCAT_IMPL(lhs, rhs)
+#define PYQCD_SCOPED_KERNEL(name, bytes, flops)                 \
+pyQCD::ScopedKernelTimer PYQCD_INSTRUMENT_CONCAT(               \
+  pyqcd_scoped_kernel_, __LINE__)(name, bytes, flops)
+
+#else
+
+#define PYQCD_SCOPED_KERNEL(name, bytes, flops)
+
+#endif
+
+#endif
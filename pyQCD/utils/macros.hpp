@@ -19,4 +19,11 @@ if (not (expr)) {                                               \
 #define pyQCDassert(expr, exception)
 #endif
 
+// Minimum trip count for per-element loops to be dispatched to the shared
+// thread pool (see utils/thread_pool.hpp); below it the dispatch handshake
+// costs more than the loop and kernels run serially.
+#ifndef PYQCD_PARALLEL_THRESHOLD
+#define PYQCD_PARALLEL_THRESHOLD 1000
+#endif
+
 #endif
\ No newline at end of file
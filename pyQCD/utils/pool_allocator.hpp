@@ -0,0 +1,145 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+/* This file provides a size-bucketed memory pool and an allocator wrapping
+ * it, for use as the Alloc template parameter of Array and Lattice. Freed
+ * blocks are cached in per-size free lists rather than returned to the
+ * general-purpose heap, so the repeated allocate/free cycles of full-size
+ * lattice temporaries in measurement loops reduce to popping a cached
+ * pointer. All blocks are 64-byte aligned, which satisfies both Eigen's
+ * alignment requirements and cache-line alignment for streaming kernels.
+ */
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace pyQCD
+{
+  class MemoryPool
+  {
+    // Process-wide arena. Blocks are bucketed by their size rounded up to a
+    // power of two, and each bucket keeps a free list of blocks available for
+    // reuse. Thread safety is provided by a single mutex; the lock is only
+    // taken on allocate/deallocate, never inside kernels.
+  public:
+    static MemoryPool& instance()
+    {
+      static MemoryPool pool;
+      return pool;
+    }
+
+    void* allocate(const std::size_t bytes)
+    {
+      const std::size_t bucket = bucket_size(bytes);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<void*>& free_list = free_blocks_[bucket];
+        if (not free_list.empty()) {
+          void* ptr = free_list.back();
+          free_list.pop_back();
+          return ptr;
+        }
+      }
+      void* ptr = nullptr;
+      if (posix_memalign(&ptr, alignment, bucket) != 0) {
+        throw std::bad_alloc();
+      }
+      return ptr;
+    }
+
+    void deallocate(void* ptr, const std::size_t bytes)
+    {
+      const std::size_t bucket = bucket_size(bytes);
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_blocks_[bucket].push_back(ptr);
+    }
+
+    // Return all cached blocks to the heap (free lists only; blocks still in
+    // use are unaffected)
+    void release_cached_blocks()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& bucket : free_blocks_) {
+        for (void* ptr : bucket.second) {
+          std::free(ptr);
+        }
+        bucket.second.clear();
+      }
+    }
+
+    static const std::size_t alignment = 64;
+
+  private:
+    MemoryPool() { }
+    ~MemoryPool() { release_cached_blocks(); }
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    static std::size_t bucket_size(const std::size_t bytes)
+    {
+      std::size_t bucket = alignment;
+      while (bucket < bytes) {
+        bucket *= 2;
+      }
+      return bucket;
+    }
+
+    std::mutex mutex_;
+    std::map<std::size_t, std::vector<void*> > free_blocks_;
+  };
+
+
+  template <typename T>
+  class PoolAllocator
+  {
+    // Drop-in replacement for std::allocator/Eigen::aligned_allocator that
+    // draws from the process-wide MemoryPool
+  public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+      typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) { }
+
+    T* allocate(const std::size_t n)
+    {
+      return static_cast<T*>(MemoryPool::instance().allocate(n * sizeof(T)));
+    }
+    void deallocate(T* ptr, const std::size_t n)
+    {
+      MemoryPool::instance().deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args)
+    { ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...); }
+    template <typename U>
+    void destroy(U* ptr) { ptr->~U(); }
+  };
+
+
+  template <typename T1, typename T2>
+  bool operator==(const PoolAllocator<T1>&, const PoolAllocator<T2>&)
+  { return true; }
+  template <typename T1, typename T2>
+  bool operator!=(const PoolAllocator<T1>&, const PoolAllocator<T2>&)
+  { return false; }
+}
+
+#endif